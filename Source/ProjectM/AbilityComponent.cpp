@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilityComponent.h"
+#include "ProjectM.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ability tick"), STAT_VenariAbilityTick, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active abilities"), STAT_VenariActiveAbilities, STATGROUP_Venari);
+
+// Sets default values for this component's properties
+UAbilityComponent::UAbilityComponent()
+{
+	// Only tick while an ability is active
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+
+// Called when the game starts
+void UAbilityComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Abilities used to be ticked at the end of the owner's tick, keep them after it
+	if (GetOwner())
+		PrimaryComponentTick.AddPrerequisite(GetOwner(), GetOwner()->PrimaryActorTick);
+}
+
+int32 UAbilityComponent::RegisterAbility(FName Name, FAbilityTickDelegate TickDelegate)
+{
+	FAbility& Ability = Abilities.AddDefaulted_GetRef();
+	Ability.Name = Name;
+	Ability.TickDelegate = MoveTemp(TickDelegate);
+
+	return Abilities.Num() - 1;
+}
+
+void UAbilityComponent::ActivateAbility(int32 Ability)
+{
+	if (!Abilities.IsValidIndex(Ability) || Abilities[Ability].bActive)
+		return;
+
+	Abilities[Ability].bActive = true;
+	ActiveAbilities.Add(Ability);
+
+	if (!IsComponentTickEnabled())
+		SetComponentTickEnabled(true);
+}
+
+void UAbilityComponent::DeactivateAbility(int32 Ability)
+{
+	if (!Abilities.IsValidIndex(Ability) || !Abilities[Ability].bActive)
+		return;
+
+	Abilities[Ability].bActive = false;
+	ActiveAbilities.Remove(Ability);
+}
+
+bool UAbilityComponent::IsAbilityActive(int32 Ability) const
+{
+	return Abilities.IsValidIndex(Ability) && Abilities[Ability].bActive;
+}
+
+// Tick every active ability, stop ticking once none is left
+void UAbilityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_VenariAbilityTick);
+	INC_DWORD_STAT_BY(STAT_VenariActiveAbilities, ActiveAbilities.Num());
+
+	TickingAbilities = ActiveAbilities;
+	for (int32 Ability : TickingAbilities)
+	{
+		// Might have been deactivated by an ability ticked before it
+		if (Abilities[Ability].bActive)
+			Abilities[Ability].TickDelegate.ExecuteIfBound(DeltaTime);
+	}
+
+	if (ActiveAbilities.Num() <= 0)
+		SetComponentTickEnabled(false);
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AbilityComponent.generated.h"
+
+DECLARE_DELEGATE_OneParam(FAbilityTickDelegate, float /*DeltaSeconds*/);
+
+/**
+ * Ticks the abilities of a character only while they are active.
+ * Abilities register a tick delegate and are activated and deactivated by the character's events,
+ * the component stops ticking altogether when no ability is active.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class PROJECTM_API UAbilityComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	UAbilityComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	int32 RegisterAbility(FName Name, FAbilityTickDelegate TickDelegate); // Returns the ability handle used to activate it
+	void ActivateAbility(int32 Ability); // Start ticking the ability
+	void DeactivateAbility(int32 Ability); // Stop ticking the ability
+
+	bool IsAbilityActive(int32 Ability) const;
+	int32 GetNumActiveAbilities() const { return ActiveAbilities.Num(); }
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+private:
+	struct FAbility
+	{
+		FName Name;
+		FAbilityTickDelegate TickDelegate;
+		bool bActive = false;
+	};
+
+	TArray<FAbility> Abilities; // Registered abilities, indexed by handle
+	TArray<int32> ActiveAbilities; // Handles of the active abilities, in activation order
+	TArray<int32> TickingAbilities; // Copy of the active abilities being ticked, abilities may deactivate themselves while ticking
+};
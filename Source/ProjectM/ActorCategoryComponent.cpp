@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorCategoryComponent.h"
+#include "ActorCategorySubsystem.h"
+#include "Enemy.h"
+#include "PlayerCharacter.h"
+#include "DestructableInterface.h"
+
+// Sets default values for this component's properties
+UActorCategoryComponent::UActorCategoryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+
+// Called when the game starts
+void UActorCategoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* Owner = GetOwner();
+	EActorCategory OwnerCategories = static_cast<EActorCategory>(Categories);
+	if (Owner->IsA<AEnemy>())
+		OwnerCategories |= EActorCategory::ENEMY;
+	if (Owner->IsA<APlayerCharacter>())
+		OwnerCategories |= EActorCategory::PLAYER;
+	if (Owner->GetClass()->ImplementsInterface(UDestructableInterface::StaticClass()))
+		OwnerCategories |= EActorCategory::DESTRUCTABLE;
+
+	GetWorld()->GetSubsystem<UActorCategorySubsystem>()->AddCategories(Owner, OwnerCategories);
+}
+
+void UActorCategoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UActorCategorySubsystem* ActorCategories = GetWorld()->GetSubsystem<UActorCategorySubsystem>())
+		ActorCategories->RemoveActor(GetOwner());
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorCategorySubsystem.h"
+#include "Enemy.h"
+#include "PlayerCharacter.h"
+#include "DestructableInterface.h"
+#include "EngineUtils.h"
+
+void UActorCategorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Actors spawned during play and levels streamed in are categorized here
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UActorCategorySubsystem::OnActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UActorCategorySubsystem::OnLevelAdded);
+}
+
+void UActorCategorySubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	Actors.Reset();
+
+	Super::Deinitialize();
+}
+
+// Categorize the level's actors once, before they begin play
+void UActorCategorySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+		AddLegacyCategories(*It);
+}
+
+void UActorCategorySubsystem::OnActorSpawned(AActor* Actor)
+{
+	AddLegacyCategories(Actor);
+}
+
+void UActorCategorySubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || Level == nullptr)
+		return;
+
+	for (AActor* Actor : Level->Actors)
+		AddLegacyCategories(Actor);
+}
+
+void UActorCategorySubsystem::AddLegacyCategories(AActor* Actor)
+{
+	if (!IsValid(Actor))
+		return;
+
+	EActorCategory Categories = EActorCategory::NONE;
+	if (Actor->ActorHasTag(TEXT("Enemy")))
+		Categories |= EActorCategory::ENEMY;
+	if (Actor->ActorHasTag(TEXT("Player")))
+		Categories |= EActorCategory::PLAYER;
+	if (Actor->ActorHasTag(TEXT("AllowedPlacing")))
+		Categories |= EActorCategory::PLACEABLE_SURFACE;
+	if (Actor->GetClass()->ImplementsInterface(UDestructableInterface::StaticClass()))
+		Categories |= EActorCategory::DESTRUCTABLE;
+
+	if (Categories == EActorCategory::NONE)
+		return;
+
+	AddCategories(Actor, Categories);
+
+	// Actors without a category component don't remove themselves
+	Actor->OnEndPlay.AddUniqueDynamic(this, &UActorCategorySubsystem::OnActorEndPlay);
+}
+
+void UActorCategorySubsystem::OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	Actor->OnEndPlay.RemoveDynamic(this, &UActorCategorySubsystem::OnActorEndPlay);
+	RemoveActor(Actor);
+}
+
+void UActorCategorySubsystem::AddCategories(AActor* Actor, EActorCategory Categories)
+{
+	if (!IsValid(Actor))
+		return;
+
+	FActorCategories& Entry = Actors.FindOrAdd(Actor);
+	Entry.Mask |= Categories;
+
+	// Typed pointers only for categories that need them, cast once here instead of at every hit
+	if (Entry.HasAny(EActorCategory::ENEMY) && Entry.Enemy == nullptr)
+		Entry.Enemy = Cast<AEnemy>(Actor);
+	if (Entry.HasAny(EActorCategory::PLAYER) && Entry.Player == nullptr)
+		Entry.Player = Cast<APlayerCharacter>(Actor);
+	if (Entry.HasAny(EActorCategory::DESTRUCTABLE) && Entry.Destructable == nullptr)
+		Entry.Destructable = Cast<IDestructableInterface>(Actor);
+}
+
+void UActorCategorySubsystem::RemoveActor(const AActor* Actor)
+{
+	Actors.Remove(Actor);
+}
+
+bool UActorCategorySubsystem::HasAnyCategory(const AActor* Actor, EActorCategory Categories) const
+{
+	const FActorCategories* Entry = Find(Actor);
+	return Entry && Entry->HasAny(Categories);
+}
+
+AEnemy* UActorCategorySubsystem::GetEnemy(const AActor* Actor) const
+{
+	const FActorCategories* Entry = Find(Actor);
+	return Entry ? Entry->Enemy : nullptr;
+}
+
+APlayerCharacter* UActorCategorySubsystem::GetPlayer(const AActor* Actor) const
+{
+	const FActorCategories* Entry = Find(Actor);
+	return Entry ? Entry->Player : nullptr;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MyEnums.h"
+#include "ActorCategorySubsystem.generated.h"
+
+class AEnemy;
+class APlayerCharacter;
+class IDestructableInterface;
+
+// Categories of an actor with its typed pointers resolved once
+struct FActorCategories
+{
+	EActorCategory Mask = EActorCategory::NONE;
+	AEnemy* Enemy = nullptr;
+	APlayerCharacter* Player = nullptr;
+	IDestructableInterface* Destructable = nullptr; // Null if only implemented in blueprints
+
+	bool HasAny(EActorCategory Categories) const { return EnumHasAnyFlags(Mask, Categories); }
+};
+
+/**
+ * Cache of every categorized actor's category bitmask, so hit and placement checks filter with a single AND
+ * instead of scanning tags by name and casting again.
+ * Actors are categorized by their category component, actors with the legacy "Enemy", "Player" or "AllowedPlacing" tags,
+ * or implementing the destructable interface, are categorized when they are spawned or their level is loaded, and removed when they end play.
+ */
+UCLASS()
+class PROJECTM_API UActorCategorySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	void AddCategories(AActor* Actor, EActorCategory Categories); // Add categories to the actor, resolving its typed pointers
+	void RemoveActor(const AActor* Actor);
+
+	const FActorCategories* Find(const AActor* Actor) const { return Actor ? Actors.Find(Actor) : nullptr; }
+	bool HasAnyCategory(const AActor* Actor, EActorCategory Categories) const;
+
+	AEnemy* GetEnemy(const AActor* Actor) const; // Null if the actor isn't a categorized enemy
+	APlayerCharacter* GetPlayer(const AActor* Actor) const; // Null if the actor isn't a categorized player
+
+private:
+	TMap<TObjectKey<AActor>, FActorCategories> Actors;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+
+	void AddLegacyCategories(AActor* Actor); // Categorize from the old tags and interfaces
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+
+	UFUNCTION()
+		void OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+};
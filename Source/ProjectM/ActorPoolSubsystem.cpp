@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorPoolSubsystem.h"
+#include "ProjectM.h"
+#include "PoolableInterface.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled actors"), STAT_VenariPooledActors, STATGROUP_Venari);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Free pooled actors"), STAT_VenariFreePooledActors, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool spawns"), STAT_VenariPoolSpawns, STATGROUP_Venari);
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	int32 NumFree = 0;
+	for (const TPair<UClass*, FActorPoolList>& Pool : Pools)
+		NumFree += Pool.Value.FreeActors.Num();
+
+	DEC_DWORD_STAT_BY(STAT_VenariPooledActors, PooledActors.Num());
+	DEC_DWORD_STAT_BY(STAT_VenariFreePooledActors, NumFree);
+
+	Pools.Reset();
+	PooledActors.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 UActorPoolSubsystem::GetNumFree(TSubclassOf<AActor> ActorClass) const
+{
+	const FActorPoolList* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->FreeActors.Num() : 0;
+}
+
+// Spawn an actor owned by the pool, ignoring collision at the spawn location
+AActor* UActorPoolSubsystem::SpawnPooledActor(UClass* ActorClass, const FTransform& Transform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+	if (Actor == nullptr)
+		return nullptr;
+
+	PooledActors.Add(Actor);
+	INC_DWORD_STAT(STAT_VenariPooledActors);
+	INC_DWORD_STAT(STAT_VenariPoolSpawns);
+	return Actor;
+}
+
+void UActorPoolSubsystem::Prewarm(TSubclassOf<AActor> ActorClass, int32 Count, const FTransform& Transform)
+{
+	if (ActorClass == nullptr)
+		return;
+
+	FActorPoolList& Pool = Pools.FindOrAdd(ActorClass);
+	while (Pool.FreeActors.Num() < Count)
+	{
+		AActor* Actor = SpawnPooledActor(ActorClass, Transform);
+		if (Actor == nullptr)
+			return;
+
+		DeactivateActor(Actor);
+		Pool.FreeActors.Add(Actor);
+		INC_DWORD_STAT(STAT_VenariFreePooledActors);
+	}
+}
+
+AActor* UActorPoolSubsystem::Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	if (ActorClass == nullptr)
+		return nullptr;
+
+	// Pop until a live actor is found, pooled actors can be destroyed by level streaming
+	AActor* Actor = nullptr;
+	FActorPoolList& Pool = Pools.FindOrAdd(ActorClass);
+	while (Actor == nullptr && Pool.FreeActors.Num() > 0)
+	{
+		AActor* Candidate = Pool.FreeActors.Pop(false);
+		DEC_DWORD_STAT(STAT_VenariFreePooledActors);
+
+		if (IsValid(Candidate))
+			Actor = Candidate;
+		else
+			PooledActors.Remove(Candidate);
+	}
+
+	// Spawned actors are already active
+	if (Actor == nullptr)
+		return SpawnPooledActor(ActorClass, Transform);
+
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+	if (IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor))
+	{
+		Poolable->OnAcquiredFromPoolCPP();
+		IPoolableInterface::Execute_OnAcquired(Actor);
+	}
+
+	return Actor;
+}
+
+void UActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor))
+		return;
+
+	// Actors the pool doesn't own are destroyed as usual
+	if (!IsPooled(Actor))
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	FActorPoolList& Pool = Pools.FindOrAdd(Actor->GetClass());
+	if (Pool.FreeActors.Contains(Actor))
+		return;
+
+	DeactivateActor(Actor);
+	Pool.FreeActors.Add(Actor);
+	INC_DWORD_STAT(STAT_VenariFreePooledActors);
+}
+
+// Park the actor, hidden and without collision or tick
+void UActorPoolSubsystem::DeactivateActor(AActor* Actor)
+{
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	if (IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor))
+	{
+		Poolable->OnReleasedToPoolCPP();
+		IPoolableInterface::Execute_OnReleased(Actor);
+	}
+}
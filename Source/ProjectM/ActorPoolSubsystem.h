@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorPoolSubsystem.generated.h"
+
+/**
+ * Released actors of a single class, waiting to be acquired
+ */
+USTRUCT()
+struct FActorPoolList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<AActor*> FreeActors;
+};
+
+/**
+ * Recycles actors instead of spawning and destroying them.
+ * Actors implementing IPoolableInterface are told when they're acquired and released,
+ * others are only hidden and have their collision and tick toggled.
+ */
+UCLASS()
+class PROJECTM_API UActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Spawn released actors of the class until the pool has at least Count of them
+	void Prewarm(TSubclassOf<AActor> ActorClass, int32 Count, const FTransform& Transform);
+
+	// Take a free actor of the class from the pool and place it, spawns one if the pool is empty
+	AActor* Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
+	template<typename T>
+	T* Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform) { return Cast<T>(Acquire(ActorClass, Transform)); }
+
+	// Return the actor to its class' pool
+	void Release(AActor* Actor);
+
+	bool IsPooled(const AActor* Actor) const { return PooledActors.Contains(Actor); }
+	int32 GetNumFree(TSubclassOf<AActor> ActorClass) const;
+
+private:
+	AActor* SpawnPooledActor(UClass* ActorClass, const FTransform& Transform);
+	void DeactivateActor(AActor* Actor);
+
+	UPROPERTY()
+		TMap<UClass*, FActorPoolList> Pools;
+
+	TSet<const AActor*> PooledActors; // Every actor owned by the pool, free or acquired
+};
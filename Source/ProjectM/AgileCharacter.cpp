@@ -12,16 +12,23 @@
 #include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "HookPoint.h"
+#include "HookPointSubsystem.h"
+#include "TraceSchedulerSubsystem.h"
+#include "AbilityComponent.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
 #include "CableComponent.h"
 #include "Components/BoxComponent.h"
 #include "DrawDebugHelpers.h"
 #include "HealthComponent.h"
 #include "Enemy.h"
+#include "ActorCategorySubsystem.h"
 
 //////////////////////////////////////////////////////////////////////////
 // AAgileCharacter
 
+static const FName RopeHandSocketName(TEXT("hand_l")); // Socket the rope starts from
+
 AAgileCharacter::AAgileCharacter()
 {
 	// Create rope end hook
@@ -58,6 +65,54 @@ void AAgileCharacter::BeginPlay()
 	// Get normal initial speeds
 	NormalMaxSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	NormalMaxAcc = GetCharacterMovement()->MaxAcceleration;
+
+	// Get hook point registry
+	HookPointSubsystem = GetWorld()->GetSubsystem<UHookPointSubsystem>();
+
+	BakeAbilityCurves();
+
+	// Register abilities, they are only ticked while active
+	RopeAbility = AbilityComponent->RegisterAbility(TEXT("Rope"),
+		FAbilityTickDelegate::CreateUObject(this, &AAgileCharacter::TickRopeAbility));
+	DashAbility = AbilityComponent->RegisterAbility(TEXT("Dash"),
+		FAbilityTickDelegate::CreateUObject(this, &AAgileCharacter::DashMovement));
+}
+
+// Bake every hook ability curve over its montage, so movement ticks don't search curve keys
+void AAgileCharacter::BakeAbilityCurves()
+{
+	BakeCurveTable(GroundGrappleCurves, { { GroundSpeedCurve }, { GroundHeightOffsetCurve }, { GroundRopeLength }, { GroundRopePosition } }, GroundGrappleMontage);
+	BakeCurveTable(AirGrappleCurves, { { AirSpeedCurve }, { AirHeightOffsetCurve }, { AirRopeLength }, { AirRopePosition } }, AirGrappleMontage);
+
+	// Grapple attack speed and height curves are sampled at three times the montage position
+	BakeCurveTable(GroundGrappleAttackCurves, { { GroundAttackSpeedCurve, 3.0f }, { GroundAttackHeightOffsetCurve, 3.0f },
+		{ GroundAttackRopeLength }, { GroundAttackRopePosition } }, GroundGrappleAttackMontage);
+	BakeCurveTable(AirGrappleAttackCurves, { { AirAttackSpeedCurve, 3.0f }, { AirAttackHeightOffsetCurve, 3.0f },
+		{ AirAttackRopeLength }, { AirAttackRopePosition } }, AirGrappleAttackMontage);
+
+	// Rope abilities pick their ground curves only while their ground montage is playing
+	RopeAbilities[(uint8)ERopeAbility::GRAPPLE] = { GroundGrappleMontage, &GroundGrappleCurves, &AirGrappleCurves };
+	RopeAbilities[(uint8)ERopeAbility::GRAPPLE_ATTACK] = { GroundGrappleAttackMontage, &GroundGrappleAttackCurves, &AirGrappleAttackCurves };
+	// Pull shares the grapple curves
+	RopeAbilities[(uint8)ERopeAbility::PULL] = { GroundGrappleMontage, &GroundGrappleCurves, &AirGrappleCurves };
+}
+
+void AAgileCharacter::BakeCurveTable(FBakedCurveTable& Table, const FBakedCurveChannel (&Channels)[FBakedCurveTable::NumChannels], const UAnimMontage* Montage)
+{
+	if (!Montage)
+	{
+		Table.Reset();
+		return;
+	}
+
+	Table.Bake(Channels, Montage->GetPlayLength(), CurveBakeSampleRate);
+
+#if WITH_EDITOR
+	const float Error = Table.ComputeMaxError(Channels);
+	if (Error > CurveBakeTolerance)
+		UE_LOG(LogTemp, Warning, TEXT("%s: baked curves of %s are off by %.2f%% of their range, raise CurveBakeSampleRate"),
+			*GetName(), *Montage->GetName(), Error * 100.0f);
+#endif
 }
 
 void AAgileCharacter::ItemAction()
@@ -81,23 +136,9 @@ void AAgileCharacter::Tick(float DeltaSeconds)
 	Super::Tick(DeltaSeconds);
 
 	// Check if can pull or grapple
-	CheckHook();
-
-	// Grappling
-	GrapplingMovement();
-	MoveGrappleRope();
+	CheckHook(DeltaSeconds);
 
-	// Grappling Attack
-	BeginGrappleAttack(DeltaSeconds);
-	GrappleAttackMovement();
-	MoveGrappleAttackRope();
-
-	// Pulling
-	PullingMovement(DeltaSeconds);
-	MovePullRope(DeltaSeconds);
-
-	// DashMovement
-	DashMovement(DeltaSeconds);
+	// Grappling, pulling and dash are ticked by the ability component while active
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -164,7 +205,7 @@ void AAgileCharacter::StopJumping()
 }
 
 // Check for valid grapple or pull position
-void AAgileCharacter::CheckHook()
+void AAgileCharacter::CheckHook(float DeltaSeconds)
 {
 	// If player dies, deactivate hook point
 	if (HealthComponent->IsDead() || bPossessing || bIsNotebookVisible)
@@ -177,38 +218,54 @@ void AAgileCharacter::CheckHook()
 	if (bIsGrappling || bIsPulling || bIsGrappleAttacking)
 		return;
 
-	// Sphere cast to detected hook points within range of player
-	TArray<TEnumAsByte<EObjectTypeQuery>> ObjTypes;
-	ObjTypes.Add(EObjectTypeQuery::ObjectTypeQuery7);
-	TArray<AActor*> ActorsToIgnore;
-	TArray<FHitResult> SphereHits;
+	// Only re-score hook points at the given rate
+	if (HookScoreRate > 0.0f)
+	{
+		HookScoreTimer -= DeltaSeconds;
+		if (HookScoreTimer > 0.0f)
+			return;
 
-	UKismetSystemLibrary::SphereTraceMultiForObjects(GetWorld(), this->GetActorLocation(), this->GetActorLocation(), DetectionDistance, ObjTypes, false, ActorsToIgnore, EDrawDebugTrace::None, SphereHits, false);
+		HookScoreTimer = 1.0f / HookScoreRate;
+	}
+
+	// Wait for the previous visibility check to come back before scoring again
+	if (PendingHookPoint.IsValid())
+		return;
+
+	// Query hook point registry for hook points within range of player
+	HookPointCandidates.Reset();
+	if (HookPointSubsystem)
+		HookPointSubsystem->QueryHookPoints(GetActorLocation(), DetectionDistance, HookPointCandidates);
 	
 	// If no hook points are within range, deactivate hook point ref
-	if (SphereHits.Num() <= 0)
+	if (HookPointCandidates.Num() <= 0)
 	{
 		DeactivateHookPointRef();
 		return;
 	}
 
 	// Check which hook point is closest to center screen
+	const FVector CameraLocation = FollowCamera->GetComponentLocation();
+	const FVector CameraForward = FollowCamera->GetForwardVector();
+
 	float HighestDot = MinDetectionDot;
-	AHookPoint* DetectedHookPoint = nullptr;
+	const int32 BestIndex = FTargetScoring::FindBestCandidate(HookPointCandidates, CameraLocation, CameraForward, MinDetectionDot, 0.0f, HighestDot);
+	AHookPoint* DetectedHookPoint = BestIndex != INDEX_NONE ? static_cast<AHookPoint*>(HookPointCandidates.Actors[BestIndex]) : nullptr;
 
-	for (int i = 0; i < SphereHits.Num(); i++)
+	// Score of the current hook point, if it's still in range
+	float CurrentHookPointDot = -1.0f;
+	const int32 CurrentIndex = CurrentHookPoint ? HookPointCandidates.Actors.Find(CurrentHookPoint) : INDEX_NONE;
+	if (CurrentIndex != INDEX_NONE)
 	{
-		FVector CurrentDirection = SphereHits[i].GetActor()->GetActorLocation() - FollowCamera->GetComponentLocation();
-		CurrentDirection.Normalize();
-		float DotProd = FVector::DotProduct(FollowCamera->GetForwardVector(), CurrentDirection);
-
-		if (DotProd > HighestDot)
-		{
-			DetectedHookPoint = Cast<AHookPoint>(SphereHits[i].GetActor());
-			HighestDot = DotProd;
-		}
+		const FVector CurrentLocation(HookPointCandidates.X[CurrentIndex], HookPointCandidates.Y[CurrentIndex], HookPointCandidates.Z[CurrentIndex]);
+		CurrentHookPointDot = FTargetScoring::ScoreLocation(CurrentLocation, CameraLocation, CameraForward);
 	}
 
+	// Keep the current hook point unless the detected one is closer to center screen by the switch margin
+	// Stops the selection from flipping between two hook points with similar scores
+	if (DetectedHookPoint != CurrentHookPoint && CurrentHookPointDot > MinDetectionDot && HighestDot < CurrentHookPointDot + HookSwitchMargin)
+		DetectedHookPoint = CurrentHookPoint;
+
 	// if no hook points are close to the center screen, if the detected hook point cant be used or its hook type is NONE
 	// deactivate hook point ref
 	if (DetectedHookPoint == nullptr || !DetectedHookPoint->CanUse() || DetectedHookPoint->Type == EHookType::NONE)
@@ -219,17 +276,56 @@ void AAgileCharacter::CheckHook()
 
 	// If the detected hook is for the grapple attack but the ability is in cooldown
 	// Deactivate hook point
-	if (DetectedHookPoint->Type == EHookType::ENEMY && CurrentGrappleAttackCooldown > 0.0f)
+	if (DetectedHookPoint->Type == EHookType::ENEMY && Cooldowns->IsCooldownActive(GrappleAttackCooldownHandle))
 	{
 		DeactivateHookPointRef();
 		return;
 	}
 
-	// Line trace to check if the detected hook point is visible
+	// Check if the detected hook point is visible
+	// Scheduled traces are resolved next frame in OnHookVisibilityTrace
+	if (bAsyncHookVisibility && TraceScheduler)
+	{
+		PendingHookPoint = DetectedHookPoint;
+		HookVisibilityRequestId = TraceScheduler->RequestLineTrace(FollowCamera->GetComponentLocation(), DetectedHookPoint->GetActorLocation(),
+			ECC_Visibility, FCollisionQueryParams::DefaultQueryParam, FScheduledTraceDelegate::CreateUObject(this, &AAgileCharacter::OnHookVisibilityTrace));
+		return;
+	}
+
 	FHitResult LineHit;
 	GetWorld()->LineTraceSingleByChannel(LineHit, FollowCamera->GetComponentLocation(),
 		DetectedHookPoint->GetActorLocation(), ECC_Visibility);
 
+	ApplyHookVisibility(DetectedHookPoint, LineHit);
+}
+
+// Consume the visibility trace scheduled by CheckHook on the previous frame
+void AAgileCharacter::OnHookVisibilityTrace(uint64 RequestId, const FTraceDatum& TraceDatum)
+{
+	// Ignore results from outdated traces
+	if (RequestId != HookVisibilityRequestId)
+		return;
+
+	AHookPoint* DetectedHookPoint = PendingHookPoint.Get();
+	PendingHookPoint = nullptr;
+	HookVisibilityRequestId = 0;
+
+	if (DetectedHookPoint == nullptr)
+		return;
+
+	// The player state might have changed while the trace was running
+	if (HealthComponent->IsDead() || bPossessing || bIsNotebookVisible)
+		return;
+
+	if (bIsGrappling || bIsPulling || bIsGrappleAttacking)
+		return;
+
+	ApplyHookVisibility(DetectedHookPoint, TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult());
+}
+
+// Activate the detected hook point if the visibility trace reached it
+void AAgileCharacter::ApplyHookVisibility(AHookPoint* DetectedHookPoint, const FHitResult& LineHit)
+{
 	// If it isn't visible, deactivate hook point ref
 	if (LineHit.Actor == nullptr)
 	{
@@ -335,6 +431,7 @@ void AAgileCharacter::GrappleAction()
 	// Tick grappling animation
 	CurrentHookPoint->Use();
 	bInGrapplingAnimation = true;
+	AbilityComponent->ActivateAbility(RopeAbility);
 
 	// Trigger animation montage depending on initial state (grounded or mid air)
 	if (GetCharacterMovement()->IsFalling())
@@ -348,30 +445,12 @@ void AAgileCharacter::GrappleAction()
 }
 
 // Handles player movement when grappling
-void AAgileCharacter::GrapplingMovement()
+void AAgileCharacter::GrapplingMovement(const FVector4& CurveValues)
 {
-	// If it's not moving using grapple return
-	if (!bMovingWithGrapple)
-		return;
-
-	// Get montage position for curves
-	UAnimInstance* AnimeInstanceRef = GetMesh()->GetAnimInstance();
-	float MontagePosition = AnimeInstanceRef->Montage_GetPosition(AnimeInstanceRef->GetCurrentActiveMontage());
-	// Target location of the grapple
-	FVector TargetLocation;
-
 	// Set target position to lerp between grapple starting position and destination, with correspondent montage speed curve as alpha
 	// Adds height offset as correspondent montage curve
-	if (AnimeInstanceRef->GetCurrentActiveMontage() == GroundGrappleMontage)
-	{
-		TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, GroundSpeedCurve->GetFloatValue(MontagePosition));
-		TargetLocation += FVector::UpVector * GroundHeightOffsetCurve->GetFloatValue(MontagePosition);
-	}
-	else
-	{
-		TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, AirSpeedCurve->GetFloatValue(MontagePosition));
-		TargetLocation += FVector::UpVector * AirHeightOffsetCurve->GetFloatValue(MontagePosition);
-	}
+	FVector TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, CurveValues.X);
+	TargetLocation += FVector::UpVector * CurveValues.Y;
 
 	// Set player position to target location
 	SetActorLocation(TargetLocation);
@@ -401,43 +480,89 @@ void AAgileCharacter::ResetGrappleMovement()
 	SetRopeVisibility(false);
 }
 
-// Handles rope and rope end movement when grappling
-void AAgileCharacter::MoveGrappleRope()
+// Picks the hook ability that drives the rope this tick
+ERopeAbility AAgileCharacter::GetActiveRopeAbility() const
 {
-	if (!bInGrapplingAnimation)
+	if (bIsPulling || bMovingWithPull)
+		return ERopeAbility::PULL;
+
+	if (bIsGrappleAttacking || bMovingWithGrappleAttack)
+		return ERopeAbility::GRAPPLE_ATTACK;
+
+	if (bInGrapplingAnimation || bMovingWithGrapple)
+		return ERopeAbility::GRAPPLE;
+
+	return ERopeAbility::NONE;
+}
+
+// Ticks the active rope ability, stops once no hook ability is in use
+void AAgileCharacter::TickRopeAbility(float DeltaSeconds)
+{
+	UpdateRopeKinematics(DeltaSeconds);
+	RequestThrowTargets();
+
+	if (GetActiveRopeAbility() == ERopeAbility::NONE)
+		AbilityComponent->DeactivateAbility(RopeAbility);
+}
+
+// Moves the active hook ability and its rope
+// Animation state and the hand socket are sampled once per tick
+void AAgileCharacter::UpdateRopeKinematics(float DeltaSeconds)
+{
+	const ERopeAbility Ability = GetActiveRopeAbility();
+	if (Ability == ERopeAbility::NONE)
+		return;
+
+	// Once the rope reached the pull target, the pulled object follows the hand instead of the montage curves
+	if (Ability == ERopeAbility::PULL && bMovingWithPull)
+	{
+		PullingMovement(DeltaSeconds, GetMesh()->GetSocketLocation(RopeHandSocketName));
 		return;
+	}
 
-	// Get current grapple montage position
+	// Sample the ability curves at the current montage position
+	// Ground or air curves are picked depending on which montage is playing
+	const FRopeAbilityDescriptor& Descriptor = RopeAbilities[(uint8)Ability];
 	UAnimInstance* AnimeInstanceRef = GetMesh()->GetAnimInstance();
-	float MontagePosition = AnimeInstanceRef->Montage_GetPosition(AnimeInstanceRef->GetCurrentActiveMontage());
+	const UAnimMontage* ActiveMontage = AnimeInstanceRef->GetCurrentActiveMontage();
+	const float MontagePosition = AnimeInstanceRef->Montage_GetPosition(ActiveMontage);
+
+	const FBakedCurveTable& Curves = ActiveMontage == Descriptor.GroundMontage ? *Descriptor.GroundCurves : *Descriptor.AirCurves;
+	const FVector4 CurveValues = Curves.Evaluate(MontagePosition);
+
+	// Move the character before sampling the hand, so the rope starts from where the hand ends up
+	if (Ability == ERopeAbility::GRAPPLE && bMovingWithGrapple)
+		GrapplingMovement(CurveValues);
+	else if (Ability == ERopeAbility::GRAPPLE_ATTACK && bMovingWithGrappleAttack)
+		GrappleAttackMovement(CurveValues);
+
+	// The rope only follows the curves while the ability's animation plays, even if the character is still moving
+	const bool bRopeAnimating = Ability == ERopeAbility::PULL ? bIsPulling
+		: Ability == ERopeAbility::GRAPPLE_ATTACK ? bIsGrappleAttacking
+		: bInGrapplingAnimation;
+	if (!bRopeAnimating)
+		return;
 
-	// Set initial target rope lenght as base value
-	float TargetLength = RopeBaseLength;
-	// Alpha value of end rope position lerp
-	float TargetPosition;
-	// Rope end position
-	FVector RopeEndPosition;
+	const FVector RopeEndPosition = MoveRope(CurveValues, GetMesh()->GetSocketLocation(RopeHandSocketName));
+
+	// Tick start of pulling object once the rope reaches it
+	if (Ability == ERopeAbility::PULL && FVector::Distance(GrapplePointPosition, RopeEndPosition) < PullSpeed * DeltaSeconds)
+		bMovingWithPull = true;
+}
 
+// Sets rope length and rope end position from the sampled rope curves, returns the rope end position
+FVector AAgileCharacter::MoveRope(const FVector4& CurveValues, const FVector& HandLocation)
+{
 	// Multiply rope length by correspondent montage float curve length
-	// Set position lerp alpha to correspondent montage float curve length
-	if (AnimeInstanceRef->GetCurrentActiveMontage() == GroundGrappleMontage)
-	{
-		TargetLength *= GroundRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = GroundRopePosition->GetFloatValue(MontagePosition);
-	}
-	else
-	{
-		TargetLength *= AirRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = AirRopePosition->GetFloatValue(MontagePosition);
-	}
-	// Set rope length
-	Rope->CableLength = TargetLength;
+	Rope->CableLength = RopeBaseLength * CurveValues.Z;
 
-	// Lerp rope end position from hand to end position by target position alpha
-	RopeEndPosition = FMath::Lerp(GetMesh()->GetSocketLocation(TEXT("hand_l")), GrapplePointPosition, TargetPosition);
+	// Lerp rope end position from hand to end position by the rope position curve
+	const FVector RopeEndPosition = FMath::Lerp(HandLocation, GrapplePointPosition, CurveValues.W);
 	Hook->SetWorldLocation(RopeEndPosition);
 	// Set rope cable end location to same position as rope end mesh (Shouldn't be necessary but bugs you know?)
 	Rope->EndLocation = RopeEndPosition;
+
+	return RopeEndPosition;
 }
 
 // Called when the player gives the pull input
@@ -476,6 +601,7 @@ void AAgileCharacter::PullAction()
 	// Tick pulling
 	CurrentHookPoint->Use();
 	bIsPulling = true;
+	AbilityComponent->ActivateAbility(RopeAbility);
 
 	// Set rope end offset to target pull actor
 	PullOffset = PullActorRef->GetOwner()->GetActorLocation() - GrapplePointPosition;
@@ -493,14 +619,10 @@ void AAgileCharacter::PullAction()
 }
 
 // Handles target and rope pulling movement towards the player
-void AAgileCharacter::PullingMovement(float DeltaTime)
+void AAgileCharacter::PullingMovement(float DeltaTime, const FVector& HandLocation)
 {
-	// If it's not moving using grapple return
-	if (!bMovingWithPull)
-		return;
-
 	// Set offseted direction from the hand to the hook mesh
-	FVector Direction = GetMesh()->GetSocketLocation(TEXT("hand_l")) - 
+	FVector Direction = HandLocation - 
 		Hook->GetComponentLocation() +
 		FollowCamera->GetForwardVector() * PullForwardOffset;
 	Direction.Normalize();
@@ -515,7 +637,7 @@ void AAgileCharacter::PullingMovement(float DeltaTime)
 	Rope->EndLocation = Hook->GetComponentLocation();
 
 	// If the pulled object is close enough to the character, stop pulling
-	if (FVector::Distance(GetMesh()->GetSocketLocation(TEXT("hand_l")), Hook->GetComponentLocation()) < PullMinDistance)
+	if (FVector::Distance(HandLocation, Hook->GetComponentLocation()) < PullMinDistance)
 	{
 		ResetPullMovement();
 		return;
@@ -588,73 +710,62 @@ void AAgileCharacter::ResetPullMovement()
 	EndPull();
 }
 
-// Handles movement of rope until it reaches the pull target
-void AAgileCharacter::MovePullRope(float DeltaTime)
+// Pick the throw target in range closest to center screen
+void AAgileCharacter::SetThrowTarget()
 {
-	if (!bIsPulling || bMovingWithPull)
-		return;
+	// Gather throw targets found by the last overlap
+	ThrowTargetCandidates.Reset();
+	for (const TWeakObjectPtr<AActor>& Target : ThrowTargetsInRange)
+	{
+		if (Target.IsValid())
+			ThrowTargetCandidates.Add(Target.Get(), Target->GetActorLocation());
+	}
 
-	// Get current grapple montage position
-	UAnimInstance* AnimeInstanceRef = GetMesh()->GetAnimInstance();
-	float MontagePosition = AnimeInstanceRef->Montage_GetPosition(AnimeInstanceRef->GetCurrentActiveMontage());
+	float HightestDotProduct = MinThrowTargetDot;
+	const int32 BestIndex = FTargetScoring::FindBestCandidate(ThrowTargetCandidates, FollowCamera->GetComponentLocation(),
+		FollowCamera->GetForwardVector(), MinThrowTargetDot, 0.0f, HightestDotProduct);
 
-	// Set initial target rope lenght as base value
-	float TargetLength = RopeBaseLength;
-	// Alpha value of end rope position lerp
-	float TargetPosition;
-	// Rope end position
-	FVector RopeEndPosition;
+	ThrowTarget = BestIndex != INDEX_NONE ? ThrowTargetCandidates.Actors[BestIndex] : nullptr;
+}
 
-	// Multiply rope length by correspondent montage float curve length
-	// Set position lerp alpha to correspondent montage float curve length
-	if (AnimeInstanceRef->GetCurrentActiveMontage() == GroundGrappleMontage)
-	{
-		TargetLength *= GroundRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = GroundRopePosition->GetFloatValue(MontagePosition);
-	}
-	else
-	{
-		TargetLength *= AirRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = AirRopePosition->GetFloatValue(MontagePosition);
-	}
-	// Set rope length
-	Rope->CableLength = TargetLength;
+// Overlap throw targets around the player while pulling, so they are ready when the object is thrown
+void AAgileCharacter::RequestThrowTargets()
+{
+	if (!bIsPulling)
+		return;
 
-	// Lerp rope end position from hand to end position by target position alpha
-	RopeEndPosition = FMath::Lerp(GetMesh()->GetSocketLocation(TEXT("hand_l")), GrapplePointPosition, TargetPosition);
-	Hook->SetWorldLocation(RopeEndPosition);
-	// Set rope cable end location to same position as rope end mesh (Shouldn't be necessary but bugs you know?)
-	Rope->EndLocation = RopeEndPosition;
+	FCollisionObjectQueryParams ObjectParams(ECC_GameTraceChannel2); // Second custom object type == ThrowTargets
+	FCollisionShape Sphere = FCollisionShape::MakeSphere(ThrowTargetDistance);
 
-	if (FVector::Distance(GrapplePointPosition, Hook->GetComponentLocation()) < PullSpeed * DeltaTime)
+	if (TraceScheduler)
 	{
-		// Tick start of pulling object
-		bMovingWithPull = true;
+		ThrowTargetsRequestId = TraceScheduler->RequestOverlap(GetActorLocation(), Sphere, ObjectParams, FCollisionQueryParams::DefaultQueryParam,
+			FScheduledOverlapDelegate::CreateUObject(this, &AAgileCharacter::OnThrowTargetsOverlap));
+		return;
 	}
+
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, GetActorLocation(), FQuat::Identity, ObjectParams, Sphere);
+	CacheThrowTargets(Overlaps);
 }
 
-void AAgileCharacter::SetThrowTarget()
+void AAgileCharacter::OnThrowTargetsOverlap(uint64 RequestId, const FOverlapDatum& OverlapDatum)
 {
-	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypesArray;
-	ObjectTypesArray.Add(ObjectTypeQuery8); // Third custom object type == ThrowTargets
-	TArray<AActor*> ActorsToIgnore;
-	TArray<FHitResult> Hits;
-
-	UKismetSystemLibrary::SphereTraceMultiForObjects(GetWorld(), GetActorLocation(), GetActorLocation(), 2000.0f, ObjectTypesArray, false, ActorsToIgnore, EDrawDebugTrace::None, Hits, false);
+	// Ignore results from outdated overlaps
+	if (RequestId != ThrowTargetsRequestId || !bIsPulling)
+		return;
 
-	float HightestDotProduct = MinThrowTargetDot;
-	ThrowTarget = nullptr;
+	ThrowTargetsRequestId = 0;
+	CacheThrowTargets(OverlapDatum.OutOverlaps);
+}
 
-	for (int i = 0; i < Hits.Num(); i++)
+void AAgileCharacter::CacheThrowTargets(const TArray<FOverlapResult>& Overlaps)
+{
+	ThrowTargetsInRange.Reset();
+	for (const FOverlapResult& Overlap : Overlaps)
 	{
-		float DotProd = FVector::DotProduct(FollowCamera->GetForwardVector(), 
-			UKismetMathLibrary::GetDirectionUnitVector(FollowCamera->GetComponentLocation(), Hits[i].GetActor()->GetActorLocation()));
-
-		if (DotProd > HightestDotProduct)
-		{
-			ThrowTarget = Hits[i].GetActor();
-			HightestDotProduct = DotProd;
-		}
+		if (Overlap.GetActor())
+			ThrowTargetsInRange.AddUnique(Overlap.GetActor());
 	}
 }
 
@@ -662,6 +773,8 @@ void AAgileCharacter::EndPull()
 {
 	PullActorRef = nullptr;
 	ThrowTarget = nullptr;
+	ThrowTargetsInRange.Reset();
+	ThrowTargetsRequestId = 0;
 
 	// Return to normal animation
 	GetMesh()->GetAnimInstance()->StopAllMontages(1.0f);
@@ -684,7 +797,7 @@ void AAgileCharacter::GrappleAttackAction()
 		return;
 
 	// Do nothing if the ability is on cooldown
-	if (CurrentGrappleAttackCooldown > 0.0f)
+	if (Cooldowns->IsCooldownActive(GrappleAttackCooldownHandle))
 		return;
 
 	// If is grappling or can't grapple return
@@ -711,15 +824,28 @@ void AAgileCharacter::SetGrappleAttackDestination()
 	GrappleDestination = GrappleAttackTarget->GetActorLocation() + GrappleAttackOffset - GetActorForwardVector() * GrappleAttackForwardOffset;
 }
 
-// Ticks cooldown and triggers beggining grapple attack
-void AAgileCharacter::BeginGrappleAttack(float DeltaSeconds)
+// Queued grapple attack starts once the current attack animation ends
+void AAgileCharacter::BeginQueuedSpecialAttack()
 {
-	// Tick ability's cooldown
-	if (CurrentGrappleAttackCooldown > 0.0f)
+	BeginGrappleAttack();
+
+	// Drop the queued attack if it couldn't start, so it doesn't block melee attacks
+	if (bQueuedGrappleAttack)
 	{
-		CurrentGrappleAttackCooldown -= DeltaSeconds;
-		return;
+		bQueuedGrappleAttack = false;
+		bQueuedSpecialAttack = false;
+
+		if (bInCombo)
+			StopCombo();
 	}
+}
+
+// Triggers beggining grapple attack
+void AAgileCharacter::BeginGrappleAttack()
+{
+	// Do nothing if the ability is on cooldown
+	if (Cooldowns->IsCooldownActive(GrappleAttackCooldownHandle))
+		return;
 
 	// Do nothing if the player character is dead or there is no valid hookpoint
 	if (HealthComponent->IsDead() || !CurrentHookPoint)
@@ -762,6 +888,12 @@ void AAgileCharacter::BeginGrappleAttack(float DeltaSeconds)
 	// The attack has now begun and isn't queued
 	bIsGrappleAttacking = true;
 	bQueuedGrappleAttack = false;
+	AbilityComponent->ActivateAbility(RopeAbility);
+}
+
+float AAgileCharacter::GetCurrentGrappleAttackCooldown() const
+{
+	return Cooldowns ? Cooldowns->GetRemainingTime(GrappleAttackCooldownHandle) : 0.0f;
 }
 
 // Begins moving character through GrappleAttackMovement()
@@ -777,80 +909,20 @@ void AAgileCharacter::StartGrapplingAttackMovement()
 }
 
 // Handles grapple attack character movement
-void AAgileCharacter::GrappleAttackMovement()
+void AAgileCharacter::GrappleAttackMovement(const FVector4& CurveValues)
 {
-	// If it's not moving using grapple return
-	if (!bMovingWithGrappleAttack)
-		return;
-
 	SetGrappleAttackDestination();
 	GrapplePointPosition = GrappleDestination;
 
-	// Get montage position for curves
-	UAnimInstance* AnimeInstanceRef = GetMesh()->GetAnimInstance();
-	float MontagePosition = AnimeInstanceRef->Montage_GetPosition(AnimeInstanceRef->GetCurrentActiveMontage());
-	// Target location of the grapple
-	FVector TargetLocation;
-
 	// Set target position to lerp between grapple starting position and destination, with correspondent montage speed curve as alpha
 	// Adds height offset as correspondent montage curve
-	if (AnimeInstanceRef->GetCurrentActiveMontage() == GroundGrappleAttackMontage)
-	{
-		TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, 
-			GroundAttackSpeedCurve->GetFloatValue(MontagePosition * 3.0f));
-		TargetLocation += FVector::UpVector * 
-			GroundAttackHeightOffsetCurve->GetFloatValue(MontagePosition * 3.0f);
-	}
-	else
-	{
-		TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, 
-			AirAttackSpeedCurve->GetFloatValue(MontagePosition * 3.0f));
-		TargetLocation += FVector::UpVector 
-			* AirAttackHeightOffsetCurve->GetFloatValue(MontagePosition * 3.0f);
-	}
+	FVector TargetLocation = FMath::Lerp(StartingPosition, GrappleDestination, CurveValues.X);
+	TargetLocation += FVector::UpVector * CurveValues.Y;
+
 	// Set player position to target location
 	SetActorLocation(TargetLocation);
 }
 
-// Handles grapple attack rope movement
-void AAgileCharacter::MoveGrappleAttackRope()
-{
-	if (!bIsGrappleAttacking)
-		return;
-
-	// Get current grapple montage position
-	UAnimInstance* AnimeInstanceRef = GetMesh()->GetAnimInstance();
-	float MontagePosition = AnimeInstanceRef->Montage_GetPosition(AnimeInstanceRef->GetCurrentActiveMontage());
-
-	// Set initial target rope lenght as base value
-	float TargetLength = RopeBaseLength;
-	// Alpha value of end rope position lerp
-	float TargetPosition;
-	// Rope end position
-	FVector RopeEndPosition;
-
-	// Multiply rope length by correspondent montage float curve length
-	// Set position lerp alpha to correspondent montage float curve length
-	if (AnimeInstanceRef->GetCurrentActiveMontage() == GroundGrappleAttackMontage)
-	{
-		TargetLength *= GroundAttackRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = GroundAttackRopePosition->GetFloatValue(MontagePosition);
-	}
-	else
-	{
-		TargetLength *= AirAttackRopeLength->GetFloatValue(MontagePosition);
-		TargetPosition = AirAttackRopePosition->GetFloatValue(MontagePosition);
-	}
-	// Set rope length
-	Rope->CableLength = TargetLength;
-
-	// Lerp rope end position from hand to end position by target position alpha
-	RopeEndPosition = FMath::Lerp(GetMesh()->GetSocketLocation(TEXT("hand_l")), GrapplePointPosition, TargetPosition);
-	Hook->SetWorldLocation(RopeEndPosition);
-	// Set rope cable end location to same position as rope end mesh (Shouldn't be necessary but bugs you know?)
-	Rope->EndLocation = RopeEndPosition;
-}
-
 // Enable melee box in animation
 void AAgileCharacter::DealGrappleAttackDamage()
 {
@@ -859,8 +931,8 @@ void AAgileCharacter::DealGrappleAttackDamage()
 		return;
 
 	// Deal damage to GrappleAttackTarget
-	if (Cast<AEnemy>(GrappleAttackTarget) != nullptr)
-		Cast<AEnemy>(GrappleAttackTarget)->TakeDamage(GrappleDamage);
+	if (AEnemy* Enemy = ActorCategories->GetEnemy(GrappleAttackTarget))
+		Enemy->TakeDamage(GrappleDamage);
 
 	// Increase attack string
 	CurrentAttackString++;
@@ -871,7 +943,7 @@ void AAgileCharacter::ResetGrappleAttack()
 {
 	// If it was using the ability, enter cooldown
 	if (bIsGrappleAttacking)
-		CurrentGrappleAttackCooldown = GrappleAttackCooldown;
+		Cooldowns->RestartCooldown(GrappleAttackCooldownHandle, GrappleAttackCooldown);
 
 	// Reset grapple attack values
 	bMovingWithGrappleAttack = false;
@@ -901,7 +973,7 @@ void AAgileCharacter::DashAction()
 		return;
 
 	// Do nothing if the ability is in cooldown
-	if (CurrentDashCooldown > 0.0f)
+	if (Cooldowns->IsCooldownActive(DashCooldownHandle))
 		return;
 
 	// if it's already dashing do nothing
@@ -932,6 +1004,7 @@ void AAgileCharacter::DashAction()
 	GetMesh()->GetAnimInstance()->Montage_Play(DashAnimation);
 	// Tick dash
 	bIsDashing = true;
+	AbilityComponent->ActivateAbility(DashAbility);
 
 	// If no input was given, dash forward
 	if (FVector::Distance(DashDirection, FVector::ZeroVector) < 0.1f)
@@ -951,13 +1024,6 @@ void AAgileCharacter::DashAction()
 // Handles dash movement
 void AAgileCharacter::DashMovement(float DeltaTime)
 {
-	// Tick ability's cooldown
-	if (CurrentDashCooldown > 0.0f)
-	{
-		CurrentDashCooldown -= DeltaTime;
-		return;
-	}
-
 	// If it's done dashing, stop
 	if (CurrentDashDistance <= 0)
 	{
@@ -996,7 +1062,13 @@ void AAgileCharacter::StopDash()
 	bIsDashing = false;
 
 	// Set cooldown
-	CurrentDashCooldown = DashCooldown;
+	Cooldowns->RestartCooldown(DashCooldownHandle, DashCooldown);
+	AbilityComponent->DeactivateAbility(DashAbility);
+}
+
+float AAgileCharacter::GetCurrentDashCooldown() const
+{
+	return Cooldowns ? Cooldowns->GetRemainingTime(DashCooldownHandle) : 0.0f;
 }
 
 // Recieve damage
@@ -5,12 +5,34 @@
 #include "CoreMinimal.h"
 #include "PlayerCharacter.h"
 #include "MyEnums.h"
+#include "WorldCollision.h"
+#include "TargetScoring.h"
+#include "BakedCurves.h"
 #include "AgileCharacter.generated.h"
 
 class AHookPoint;
+class UHookPointSubsystem;
 class UAnimMontage;
 class UCableComponent;
 
+// Hook abilities that move the rope
+enum class ERopeAbility : uint8
+{
+	NONE,
+	GRAPPLE,
+	GRAPPLE_ATTACK,
+	PULL,
+	MAX
+};
+
+// Montage and baked curves a rope ability samples every tick
+struct FRopeAbilityDescriptor
+{
+	const UAnimMontage* GroundMontage = nullptr; // Montage that selects the ground curves, any other montage selects the air curves
+	const FBakedCurveTable* GroundCurves = nullptr;
+	const FBakedCurveTable* AirCurves = nullptr;
+};
+
 UCLASS(config = Game)
 class AAgileCharacter : public APlayerCharacter
 {
@@ -51,6 +73,7 @@ protected:
 protected:
 	virtual void ItemAction() override;
 	virtual void PlaceAction() override;
+	virtual void BeginQueuedSpecialAttack() override;
 
 
 	// ______HOOK_____
@@ -68,7 +91,16 @@ private:
 
 	void ActivateHookPoint(AHookPoint* TargetHookPoint);
 	void DeactivateHookPointRef();
-	void CheckHook(); // Check for pullable and grappable objects
+	void CheckHook(float DeltaSeconds); // Check for pullable and grappable objects
+	void OnHookVisibilityTrace(uint64 RequestId, const FTraceDatum& TraceDatum); // Scheduled visibility trace result of the detected hook point
+	void ApplyHookVisibility(AHookPoint* DetectedHookPoint, const FHitResult& LineHit); // Activate detected hook point if it's visible
+
+	UHookPointSubsystem* HookPointSubsystem = nullptr; // World hook point registry used to find hook points in range
+	FTargetCandidates HookPointCandidates; // Hook points in range, reused every frame
+
+	float HookScoreTimer = 0.0f; // Time left until hook points are scored again
+	TWeakObjectPtr<AHookPoint> PendingHookPoint; // Hook point waiting for its visibility trace result
+	uint64 HookVisibilityRequestId = 0;
 
 	FVector GrappleDestination; // End location of grapple
 	FVector GrapplePointPosition; // Position to which the rope end will go to
@@ -79,6 +111,12 @@ private:
 
 	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"), Category = "Hook")
 		float MinDetectionDot = 0.7f; // Min dot product to consider that a hook point is at center screen
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"), Category = "Hook")
+		float HookSwitchMargin = 0.02f; // Dot product margin a hook point needs over the current one to replace it
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"), Category = "Hook")
+		float HookScoreRate = 20.0f; // Times per second hook points are scored, 0 scores every frame
+	UPROPERTY(EditAnywhere, Category = "Hook")
+		bool bAsyncHookVisibility = true; // Check hook point visibility with an async trace, resolved on the next frame
 
 
 
@@ -91,8 +129,7 @@ public:
 
 private:
 	void GrappleAction(); // Called when the player gives the grapple input
-	void GrapplingMovement(); // Handles player movement when grappling
-	void MoveGrappleRope(); // Handles rope and rope end movement when grappling
+	void GrapplingMovement(const FVector4& CurveValues); // Handles player movement when grappling
 
 	UPROPERTY(EditAnywhere, Category = "Grapple")
 		UAnimMontage* GroundGrappleMontage; // Animation montage of grappling when grounded (has notifies used to trigger grapple states)
@@ -127,15 +164,37 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Grapple")
 		float GrappleLandingOffset = 50.0f; // Z grapple landing offset
 
+	// Grapple curves baked over the montage length at BeginPlay
+	// Channels: X = speed, Y = height offset, Z = rope length, W = rope position
+	FBakedCurveTable GroundGrappleCurves;
+	FBakedCurveTable AirGrappleCurves;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Curves")
+		float CurveBakeSampleRate = 120.0f; // Samples per second of montage when baking the hook ability curves
+	UPROPERTY(EditDefaultsOnly, Category = "Curves")
+		float CurveBakeTolerance = 0.01f; // Max baked curve error relative to the curve's value range, checked in editor builds
+
+	void BakeAbilityCurves(); // Bakes grapple and grapple attack curves into sample tables and sets up the rope abilities
+	void BakeCurveTable(FBakedCurveTable& Table, const FBakedCurveChannel (&Channels)[FBakedCurveTable::NumChannels], const UAnimMontage* Montage);
+
+	FRopeAbilityDescriptor RopeAbilities[(uint8)ERopeAbility::MAX]; // Indexed by ERopeAbility
+	ERopeAbility GetActiveRopeAbility() const;
+	void UpdateRopeKinematics(float DeltaSeconds); // Moves the active hook ability's character and rope, once per tick
+	void TickRopeAbility(float DeltaSeconds); // Ticked by the ability component while a hook ability is in use
+	int32 RopeAbility = INDEX_NONE;
+	FVector MoveRope(const FVector4& CurveValues, const FVector& HandLocation); // Sets rope length and end position from the sampled curves
+
 
 
 	//______PULLING_____
 private:
 	void PullAction(); // Handles pull input
-	void PullingMovement(float DeltaTime); // Handles target and rope pulling movement towards the player
+	void PullingMovement(float DeltaTime, const FVector& HandLocation); // Handles target and rope pulling movement towards the player
 	void ResetPullMovement(); // Reset pulling movement, return to normal state
-	void MovePullRope(float DeltaTime); // Handles movement of rope until it reaches the pull target
 	void SetThrowTarget();
+	void RequestThrowTargets(); // Refresh the throw targets in range while pulling
+	void OnThrowTargetsOverlap(uint64 RequestId, const FOverlapDatum& OverlapDatum);
+	void CacheThrowTargets(const TArray<FOverlapResult>& Overlaps);
 	void EndPull();
 
 	UPROPERTY(EditAnywhere, Category = "Pull")
@@ -163,7 +222,12 @@ private:
 	FVector PullOffset; // Offset between the hook impact point and the pull object
 
 	AActor* ThrowTarget; // Target actor towards which the pulled object will be thrown
+	TArray<TWeakObjectPtr<AActor>> ThrowTargetsInRange; // Throw targets found by the last overlap
+	FTargetCandidates ThrowTargetCandidates; // Throw targets in range, reused every frame
+	uint64 ThrowTargetsRequestId = 0;
 
+	UPROPERTY(EditAnywhere, Category = "Pull")
+		float ThrowTargetDistance = 2000.0f; // Max distance from the player to find throw targets
 	UPROPERTY(EditAnywhere, Category = "Pull", meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
 		float MinThrowTargetDot = 0.7f; // Min dot product to consider that a throw target is at center screen
 	UPROPERTY(EditAnywhere, Category = "Pull", meta = (ClampMin = "-1.0", ClampMax = "1.0", UIMin = "-1.0", UIMax = "1.0"))
@@ -188,8 +252,10 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Grapple Attack")
 		void DealGrappleAttackDamage(); // Activate melee trigger box
-	UPROPERTY(BlueprintReadOnly)
-		float CurrentGrappleAttackCooldown = 0.0f;
+	UPROPERTY(BlueprintReadOnly, BlueprintGetter = GetCurrentGrappleAttackCooldown)
+		float CurrentGrappleAttackCooldown = 0.0f; // Never written, blueprints read it through the getter
+	UFUNCTION(BlueprintGetter)
+		float GetCurrentGrappleAttackCooldown() const; // Seconds left of grapple attack cooldown
 
 private:
 	UPROPERTY(EditAnywhere, Category = "Grapple Attack")
@@ -199,9 +265,9 @@ private:
 	void SetGrappleAttackDestination();
 
 	void GrappleAttackAction(); // Called when the player gives the grapple input
-	void BeginGrappleAttack(float DeltaSeconds); // Ticks grapple attack cooldown and sets initial values
-	void GrappleAttackMovement(); // Handles player movement when grappling
-	void MoveGrappleAttackRope(); // Handles rope and rope end movement when grappling
+	void BeginGrappleAttack(); // Sets grapple attack initial values, if it's queued and can start
+	FCooldownHandle GrappleAttackCooldownHandle;
+	void GrappleAttackMovement(const FVector4& CurveValues); // Handles player movement when grappling
 
 	UPROPERTY(EditAnywhere, Category = "Grapple Attack")
 		UAnimMontage* GroundGrappleAttackMontage; // Animation montage of grappling when grounded (has notifies used to trigger grapple states)
@@ -237,6 +303,11 @@ private:
 
 	bool bQueuedGrappleAttack; // Is the grapple attack ability set to be triggered whenever it's possible
 
+	// Grapple attack curves baked over the montage length at BeginPlay, speed and height offset already include the montage time scale
+	// Channels: X = speed, Y = height offset, Z = rope length, W = rope position
+	FBakedCurveTable GroundGrappleAttackCurves;
+	FBakedCurveTable AirGrappleAttackCurves;
+
 	UPROPERTY(EditAnywhere, Category = "Grapple Attack")
 		float GrappleAttackCooldown = 1.0f;
 
@@ -244,11 +315,15 @@ private:
 
 	// _____DASH_____
 public:
-	UPROPERTY(BlueprintReadOnly)
-		float CurrentDashCooldown = 0.0f;
+	UPROPERTY(BlueprintReadOnly, BlueprintGetter = GetCurrentDashCooldown)
+		float CurrentDashCooldown = 0.0f; // Never written, blueprints read it through the getter
+	UFUNCTION(BlueprintGetter)
+		float GetCurrentDashCooldown() const; // Seconds left of dash cooldown
 private:
 	void DashAction(); // Handles dash input
 	void DashMovement(float DeltaTime); // Handles dash movement
+	int32 DashAbility = INDEX_NONE;
+	FCooldownHandle DashCooldownHandle;
 	void StopDash();
 
 	FVector DashDirection;
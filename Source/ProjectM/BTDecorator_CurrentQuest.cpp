@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTDecorator_CurrentQuest.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "QuestSubsystem.h"
+
+UBTDecorator_CurrentQuest::UBTDecorator_CurrentQuest()
+{
+	NodeName = TEXT("Current Quest");
+}
+
+bool UBTDecorator_CurrentQuest::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	UGameInstance* GameInstance = OwnerComp.GetWorld() ? OwnerComp.GetWorld()->GetGameInstance() : nullptr;
+	if (!GameInstance)
+		return false;
+
+	return GameInstance->GetSubsystem<UQuestSubsystem>()->IsQuestActive(QuestName);
+}
+
+FString UBTDecorator_CurrentQuest::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s is active"), *Super::GetStaticDescription(), *QuestName.ToString());
+}
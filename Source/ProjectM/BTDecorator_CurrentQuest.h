@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTDecorator.h"
+#include "BTDecorator_CurrentQuest.generated.h"
+
+/**
+ * Passes if the quest, by quest data table row or quest name, is active.
+ */
+UCLASS()
+class PROJECTM_API UBTDecorator_CurrentQuest : public UBTDecorator
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_CurrentQuest();
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+	virtual FString GetStaticDescription() const override;
+
+	UPROPERTY(EditAnywhere, Category = "Quest")
+		FName QuestName;
+};
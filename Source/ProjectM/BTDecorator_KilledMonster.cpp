@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTDecorator_KilledMonster.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "QuestSubsystem.h"
+
+UBTDecorator_KilledMonster::UBTDecorator_KilledMonster()
+{
+	NodeName = TEXT("Killed Monster");
+}
+
+bool UBTDecorator_KilledMonster::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	UGameInstance* GameInstance = OwnerComp.GetWorld() ? OwnerComp.GetWorld()->GetGameInstance() : nullptr;
+	if (!GameInstance)
+		return false;
+
+	return GameInstance->GetSubsystem<UQuestSubsystem>()->GetKillCount(MonsterName) >= MinKills;
+}
+
+FString UBTDecorator_KilledMonster::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s killed %d times"), *Super::GetStaticDescription(), *MonsterName.ToString(), MinKills);
+}
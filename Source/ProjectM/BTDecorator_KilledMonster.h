@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTDecorator.h"
+#include "BTDecorator_KilledMonster.generated.h"
+
+/**
+ * Passes if the monster was killed at least the given number of times, read from the quest subsystem's kill counters.
+ */
+UCLASS()
+class PROJECTM_API UBTDecorator_KilledMonster : public UBTDecorator
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_KilledMonster();
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+	virtual FString GetStaticDescription() const override;
+
+	UPROPERTY(EditAnywhere, Category = "Quest")
+		FName MonsterName;
+
+	UPROPERTY(EditAnywhere, Category = "Quest", meta = (ClampMin = "1"))
+		int32 MinKills = 1;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BakedCurves.h"
+#include "Curves/CurveFloat.h"
+#include "Math/VectorRegister.h"
+
+static float SampleChannel(const FBakedCurveChannel& Channel, float Time)
+{
+	return Channel.Curve ? Channel.Curve->GetFloatValue(Time * Channel.TimeScale) : 0.0f;
+}
+
+void FBakedCurveTable::Bake(const FBakedCurveChannel (&Channels)[NumChannels], float InDuration, float SampleRate)
+{
+	Duration = FMath::Max(InDuration, 0.0f);
+
+	// Always keep at least the two end samples so evaluation never has to branch on the table size
+	NumSamples = FMath::Max(FMath::CeilToInt(Duration * SampleRate), 1) + 1;
+	SamplesPerSecond = Duration > 0.0f ? (NumSamples - 1) / Duration : 0.0f;
+
+	Samples.SetNumUninitialized(NumSamples * NumChannels);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		const float Time = SamplesPerSecond > 0.0f ? i / SamplesPerSecond : 0.0f;
+		for (int32 Channel = 0; Channel < NumChannels; Channel++)
+			Samples[i * NumChannels + Channel] = SampleChannel(Channels[Channel], Time);
+	}
+}
+
+void FBakedCurveTable::Reset()
+{
+	Samples.Reset();
+	NumSamples = 0;
+	Duration = 0.0f;
+	SamplesPerSecond = 0.0f;
+}
+
+FVector4 FBakedCurveTable::Evaluate(float Time) const
+{
+	if (!IsBaked())
+		return FVector4(0.0f, 0.0f, 0.0f, 0.0f);
+
+	// Split time into a sample index and the alpha to the next sample
+	const float SamplePosition = FMath::Clamp(Time * SamplesPerSecond, 0.0f, (float)(NumSamples - 1));
+	const int32 Index = FMath::Min(FMath::TruncToInt(SamplePosition), NumSamples - 2);
+	const VectorRegister Alpha = VectorSetFloat1(SamplePosition - Index);
+
+	// Lerp all channels at once
+	const VectorRegister From = VectorLoadAligned(&Samples[Index * NumChannels]);
+	const VectorRegister To = VectorLoadAligned(&Samples[(Index + 1) * NumChannels]);
+
+	FVector4 Result;
+	VectorStoreAligned(VectorMultiplyAdd(VectorSubtract(To, From), Alpha, From), &Result);
+	return Result;
+}
+
+#if WITH_EDITOR
+float FBakedCurveTable::ComputeMaxError(const FBakedCurveChannel (&Channels)[NumChannels], int32 SubSamples) const
+{
+	if (!IsBaked() || SamplesPerSecond <= 0.0f)
+		return 0.0f;
+
+	// Value range of each channel, so channels in different units share the same tolerance
+	float Ranges[NumChannels];
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		float MinValue = Samples[Channel];
+		float MaxValue = Samples[Channel];
+		for (int32 i = 1; i < NumSamples; i++)
+		{
+			MinValue = FMath::Min(MinValue, Samples[i * NumChannels + Channel]);
+			MaxValue = FMath::Max(MaxValue, Samples[i * NumChannels + Channel]);
+		}
+		Ranges[Channel] = FMath::Max(MaxValue - MinValue, 1.0f);
+	}
+
+	const int32 NumChecks = (NumSamples - 1) * FMath::Max(SubSamples, 1);
+	const float CheckStep = Duration / NumChecks;
+
+	float MaxError = 0.0f;
+	for (int32 i = 0; i <= NumChecks; i++)
+	{
+		const float Time = i * CheckStep;
+		const FVector4 Baked = Evaluate(Time);
+		for (int32 Channel = 0; Channel < NumChannels; Channel++)
+		{
+			const float Error = FMath::Abs(Baked[Channel] - SampleChannel(Channels[Channel], Time)) / Ranges[Channel];
+			MaxError = FMath::Max(MaxError, Error);
+		}
+	}
+
+	return MaxError;
+}
+#endif
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCurveFloat;
+
+/**
+ * Curve sampled into a baked table channel, TimeScale multiplies the table time before sampling the curve
+ */
+struct FBakedCurveChannel
+{
+	const UCurveFloat* Curve = nullptr;
+	float TimeScale = 1.0f;
+};
+
+/**
+ * Four float curves baked into one fixed resolution sample table, interleaved so every channel
+ * is evaluated at once with a single vector lerp instead of four keyed curve searches.
+ */
+struct PROJECTM_API FBakedCurveTable
+{
+public:
+	static constexpr int32 NumChannels = 4;
+
+	// Sample every channel over [0, Duration] at the given rate (samples per second)
+	// Null curves bake to 0
+	void Bake(const FBakedCurveChannel (&Channels)[NumChannels], float Duration, float SampleRate);
+	void Reset();
+
+	// Linearly interpolated value of the four channels at time, clamped to the baked duration
+	FVector4 Evaluate(float Time) const;
+
+	bool IsBaked() const { return NumSamples > 1; }
+	float GetDuration() const { return Duration; }
+
+#if WITH_EDITOR
+	// Largest difference between the table and the source curves, relative to each channel's value range
+	// Evaluated in between samples, where linear interpolation is furthest from the curve
+	float ComputeMaxError(const FBakedCurveChannel (&Channels)[NumChannels], int32 SubSamples = 4) const;
+#endif
+
+private:
+	TArray<float, TAlignedHeapAllocator<16>> Samples; // NumSamples * NumChannels values, one aligned vector per sample
+	int32 NumSamples = 0;
+	float Duration = 0.0f;
+	float SamplesPerSecond = 0.0f;
+};
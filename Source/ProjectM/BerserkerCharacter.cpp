@@ -10,6 +10,9 @@
 #include "CableComponent.h"
 #include "Enemy.h"
 #include "DestructableInterface.h"
+#include "AbilityComponent.h"
+#include "MeleeTraceComponent.h"
+#include "ActorCategorySubsystem.h"
 
 
 ABerserkerCharacter::ABerserkerCharacter()
@@ -18,6 +21,9 @@ ABerserkerCharacter::ABerserkerCharacter()
 	BashTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("Shoulder Bash Trigger"));
 	BashTrigger->SetupAttachment(RootComponent);
 	BashTrigger->bEditableWhenInherited = true;
+
+	// Create shoulder bash trace component
+	BashTrace = CreateDefaultSubobject<UMeleeTraceComponent>(TEXT("BashTrace"));
 }
 
 void ABerserkerCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
@@ -43,75 +49,75 @@ void ABerserkerCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Assign overlap event to shoulder bash trigger box
-	BashTrigger->OnComponentBeginOverlap.AddDynamic(this, &ABerserkerCharacter::OnShoulderBashBeginOverlap);
+	// Shoulder bash trigger box is only swept, it doesn't need to collide
+	BashTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	BashTrace->SetTraceBox(BashTrigger);
+	BashTrace->OnHits.BindUObject(this, &ABerserkerCharacter::OnShoulderBashHits);
 
 	// Get normal initial speeds
 	NormalSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	NormalAcceleration = GetCharacterMovement()->MaxAcceleration;
-}
-
-void ABerserkerCharacter::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
 
-	// Shoulder Bash
-	BeginShoulderBash();
-	BashMovement(DeltaSeconds);
-	TickBashCooldown(DeltaSeconds);
-	
-	// Boosts
-	TickLifeSteal(DeltaSeconds);
-	TickBerserkBoost(DeltaSeconds);
+	// Register abilities, they are only ticked while active
+	BashMovementAbility = AbilityComponent->RegisterAbility(TEXT("ShoulderBash"),
+		FAbilityTickDelegate::CreateUObject(this, &ABerserkerCharacter::BashMovement));
 }
 
-void ABerserkerCharacter::OnShoulderBashBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+// Each actor is only hit once per bash
+void ABerserkerCharacter::OnShoulderBashHits(const TArray<AActor*>& HitActors)
 {
-	if (!OtherActor || OtherActor == this)
-		return;
-	
-	// If an enemy enters the trigger box
-	// Damage it
-	// And knockback
-	if (OtherActor->ActorHasTag(TEXT("Enemy")))
+	for (AActor* OtherActor : HitActors)
 	{
-		FVector KnockDirection = OtherActor->GetActorLocation() - GetActorLocation();
-		KnockDirection.Normalize();
+		if (!IsValid(OtherActor) || OtherActor == this)
+			continue;
+
+		const FActorCategories* Found = ActorCategories->Find(OtherActor);
+		if (Found == nullptr)
+			continue;
+
+		// Copied, damage and destruction can spawn or destroy categorized actors and reallocate the entries
+		const FActorCategories Categories = *Found;
 
-		if (Cast<AEnemy>(OtherActor) != nullptr)
+		// If an enemy is hit
+		// Damage it
+		// And knockback
+		if (Categories.HasAny(EActorCategory::ENEMY))
 		{
-			AEnemy* E = Cast<AEnemy>(OtherActor);
-			E->TakeDamage(BashDamage);
-	
-			if (CurrentBashDistance <= BashDistance * (1 - BashDistancePercentToKnockback))
+			FVector KnockDirection = OtherActor->GetActorLocation() - GetActorLocation();
+			KnockDirection.Normalize();
+
+			if (AEnemy* E = Categories.Enemy)
 			{
-				E->Knockback(KnockDirection * BashKnockbackForce);
+				E->TakeDamage(BashDamage);
+
+				if (CurrentBashDistance <= BashDistance * (1 - BashDistancePercentToKnockback))
+				{
+					E->Knockback(KnockDirection * BashKnockbackForce);
+				}
 			}
-		}
-		
-		CurrentAttackString++;
 
-		// If it's using the life steal boost
-		// Heal percentage of given damage
-		if (bUsingLifeSteal)
-			HealthComponent->Heal(Damage * LifeStealPercent);
-	}
+			CurrentAttackString++;
 
-	if (OtherActor->GetClass()->ImplementsInterface(UDestructableInterface::StaticClass()))
-	{
-		// Execute destructable's action (BLUEPRINT)
-		IDestructableInterface::Execute_OnDestruction(OtherActor, this);
+			// If it's using the life steal boost
+			// Heal percentage of given damage
+			if (bUsingLifeSteal)
+				HealthComponent->Heal(Damage * LifeStealPercent);
+		}
 
-		// Check if object was deleted during it's action call
-		if (OtherActor == nullptr)
-			return;
+		if (Categories.HasAny(EActorCategory::DESTRUCTABLE))
+		{
+			IDestructableInterface* Destructable = Categories.Destructable;
+
+			// Execute destructable's action (BLUEPRINT)
+			IDestructableInterface::Execute_OnDestruction(OtherActor, this);
 
-		// Execute the destructable's action (CPP)
-		IDestructableInterface* Destructable = Cast<IDestructableInterface>(OtherActor);
-		if (!Destructable)
-			return;
+			// Check if object was destroyed during it's action call
+			if (!IsValid(OtherActor) || !Destructable)
+				continue;
 
-		Destructable->OnDestruction(this);
+			// Execute the destructable's action (CPP)
+			Destructable->OnDistructionCPP(this);
+		}
 	}
 
 	// Finish shoulder bash if it's supposed to
@@ -122,16 +128,16 @@ void ABerserkerCharacter::OnShoulderBashBeginOverlap(UPrimitiveComponent* Overla
 	}
 }
 
-// Enable bash box in animation
+// Start bash sweep in animation
 void ABerserkerCharacter::BeginBashAttack()
 {
-	BashTrigger->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	BashTrace->BeginSwing();
 }
 
-// Disable bash box in animation
+// Stop bash sweep in animation
 void ABerserkerCharacter::EndBashAttack()
 {
-	BashTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	BashTrace->EndSwing();
 }
 
 
@@ -172,7 +178,7 @@ void ABerserkerCharacter::ShoulderBashAction()
 	// Or on cooldown
 	if (bIsBashing ||
 		GetCharacterMovement()->IsFalling() ||
-		CurrentBashCooldown > 0.0f)
+		Cooldowns->IsCooldownActive(BashCooldownHandle))
 		return;
 
 	if (bInAttackAnimation && !bCanCombo)
@@ -184,6 +190,12 @@ void ABerserkerCharacter::ShoulderBashAction()
 	bEndingCombo = false;
 }
 
+// Queued shoulder bash starts once the current attack animation ends
+void ABerserkerCharacter::BeginQueuedSpecialAttack()
+{
+	BeginShoulderBash();
+}
+
 void ABerserkerCharacter::BeginShoulderBash()
 {
 	// Do nothing if the ability isn't queued or the character is in the middle of an attack animation
@@ -209,7 +221,8 @@ void ABerserkerCharacter::EndShoulderBash()
 	bIsBashing = false;
 	bMoveWithBash = false;
 	bQueuedSpecialAttack = false;
-	CurrentBashCooldown = BashCooldown;
+	Cooldowns->RestartCooldown(BashCooldownHandle, BashCooldown);
+	AbilityComponent->DeactivateAbility(BashMovementAbility);
 	EndAttackAnimation();
 }
 
@@ -218,6 +231,7 @@ void ABerserkerCharacter::BeginBashMovement()
 {
 	// Tick start of shoulder bash movement
 	bMoveWithBash = true;
+	AbilityComponent->ActivateAbility(BashMovementAbility);
 	// Set movement values
 	GetCharacterMovement()->MaxWalkSpeed = BashSpeed;
 	GetCharacterMovement()->MaxAcceleration = BashAcceleration;
@@ -227,6 +241,7 @@ void ABerserkerCharacter::BeginBashMovement()
 void ABerserkerCharacter::EndBashMovement()
 {
 	bMoveWithBash = false;
+	AbilityComponent->DeactivateAbility(BashMovementAbility);
 
 	// Reset movement values
 	GetCharacterMovement()->MaxWalkSpeed = NormalSpeed;
@@ -258,13 +273,9 @@ void ABerserkerCharacter::BashMovement(float DeltaSeconds)
 	}
 }
 
-// Decrease bash cooldown
-void ABerserkerCharacter::TickBashCooldown(float DeltaSeconds)
+float ABerserkerCharacter::GetCurrentBashCooldown() const
 {
-	if (CurrentBashCooldown < 0.0f)
-		return;
-
-	CurrentBashCooldown -= DeltaSeconds;
+	return Cooldowns ? Cooldowns->GetRemainingTime(BashCooldownHandle) : 0.0f;
 }
 
 void ABerserkerCharacter::UseBoost(EBoostType BoostType)
@@ -279,82 +290,52 @@ void ABerserkerCharacter::UseBoost(EBoostType BoostType)
 
 	// Check the type of boost
 	// If it's using the boost or on cooldown, do nothing
-	// Set boost duration and tick its usage
+	// Start boost duration, the boost ends when it expires
 	switch (BoostType)
 	{
 		case EBoostType::LIFESTEAL:
-			if (bUsingLifeSteal || CurrentLifeStealCooldown > 0.0f)
+			if (bUsingLifeSteal || Cooldowns->IsCooldownActive(LifeStealCooldownHandle))
 				return;
-			CurrentLifeStealDuration = LifeStealDuration;
 			bUsingLifeSteal = true;
+			Cooldowns->RestartCooldown(LifeStealDurationHandle, LifeStealDuration,
+				FCooldownExpiredDelegate::CreateUObject(this, &ABerserkerCharacter::EndLifeSteal));
 			break;
 
 		case EBoostType::BERSERK:
-			if (bUsingBerserk || CurrentBerserkCooldown > 0.0f)
+			if (bUsingBerserk || Cooldowns->IsCooldownActive(BerserkCooldownHandle))
 				return;
 			OriginalDamage = Damage; // Store original value to reset damage later
 			Damage = OriginalDamage + DamageBoost; // Add boost to original damage
-			CurrentBerserkDuration = BerserkDuration;
 			bUsingBerserk = true;
+			Cooldowns->RestartCooldown(BerserkDurationHandle, BerserkDuration,
+				FCooldownExpiredDelegate::CreateUObject(this, &ABerserkerCharacter::EndBerserkBoost));
 			break;
 	}
 }
 
-void ABerserkerCharacter::TickLifeSteal(float DeltaSeconds)
+// Tick off boost usage and set its cooldown
+void ABerserkerCharacter::EndLifeSteal()
 {
-	// Do nothing if dead
-	if (HealthComponent->IsDead())
-		return;
-
-	// If it's not using the boost or on cooldown, do nothing
-	if (!bUsingLifeSteal && CurrentLifeStealCooldown < 0.0f)
-		return;
-
-	// Tick boost duration
-	if (CurrentLifeStealDuration > 0.0f)
-	{
-		CurrentLifeStealDuration -= DeltaSeconds;
-		return;
-	}
-	// When it ends set boost cooldown and tick off its usage
-	else if (bUsingLifeSteal)
-	{
-		CurrentLifeStealCooldown = LifeStealCooldown;
-		bUsingLifeSteal = false;
-		return;
-	}
-
-	// Tick cooldown
-	CurrentLifeStealCooldown -= DeltaSeconds;
+	bUsingLifeSteal = false;
+	Cooldowns->RestartCooldown(LifeStealCooldownHandle, LifeStealCooldown);
 }
 
-void ABerserkerCharacter::TickBerserkBoost(float DeltaSeconds)
+// Reset damage, tick off boost usage and set its cooldown
+void ABerserkerCharacter::EndBerserkBoost()
 {
-	// Do nothing if dead
-	if (HealthComponent->IsDead())
-		return;
-
-	// If it's not using the boost or on cooldown, do nothing
-	if (!bUsingBerserk && CurrentBerserkCooldown < 0.0f)
-		return;
+	Damage = OriginalDamage;
+	bUsingBerserk = false;
+	Cooldowns->RestartCooldown(BerserkCooldownHandle, BerserkCooldown);
+}
 
-	// Tick boost duration
-	if (CurrentBerserkDuration > 0.0f)
-	{
-		CurrentBerserkDuration -= DeltaSeconds;
-		return;
-	}
-	// When it ends set boost cooldown and tick off its usage
-	else if (bUsingBerserk)
-	{
-		CurrentBerserkCooldown = BerserkCooldown;
-		Damage = OriginalDamage;
-		bUsingBerserk = false;
-		return;
-	}
+float ABerserkerCharacter::GetCurrentLifeStealCooldown() const
+{
+	return Cooldowns ? Cooldowns->GetRemainingTime(LifeStealCooldownHandle) : 0.0f;
+}
 
-	// Tick cooldown
-	CurrentBerserkCooldown -= DeltaSeconds;
+float ABerserkerCharacter::GetCurrentBerserkCooldown() const
+{
+	return Cooldowns ? Cooldowns->GetRemainingTime(BerserkCooldownHandle) : 0.0f;
 }
 
 void ABerserkerCharacter::TakeDamage(float Amount)
@@ -370,18 +351,18 @@ void ABerserkerCharacter::TakeDamage(float Amount)
 	Super::TakeDamage(Amount);
 }
 
-void ABerserkerCharacter::OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void ABerserkerCharacter::OnMeleeHits(const TArray<AActor*>& HitActors)
 {
 	// Do nothing if dead
 	if (HealthComponent->IsDead())
 		return;
 
-	// If it's using the life steal boost
-	// Heal percentage of given damage
-	if (bUsingLifeSteal)
-		HealthComponent->Heal(Damage * LifeStealPercent);
+	const int32 NumDamaged = DealMeleeDamage(HitActors);
 
-	Super::OnMeleeBoxBeginOverlap(OverlappedComp, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+	// If it's using the life steal boost
+	// Heal percentage of given damage for every enemy damaged
+	if (bUsingLifeSteal && NumDamaged > 0)
+		HealthComponent->Heal(Damage * LifeStealPercent * NumDamaged);
 }
 
 void ABerserkerCharacter::ItemAction()
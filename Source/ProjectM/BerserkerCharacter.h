@@ -21,7 +21,6 @@ class PROJECTM_API ABerserkerCharacter : public APlayerCharacter
 		// _____COMPONENTS_____
 public:
 	ABerserkerCharacter();
-	virtual void Tick(float DeltaSeconds) override;
 
 protected:
 	virtual void Jump() override;
@@ -44,7 +43,8 @@ public:
 	virtual void TakeDamage(float Amount) override;
 
 protected:
-	virtual void OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) override;
+	virtual void OnMeleeHits(const TArray<AActor*>& HitActors) override;
+	virtual void BeginQueuedSpecialAttack() override;
 
 
 
@@ -58,20 +58,24 @@ protected:
 	// _____SHOULDER_BASH_____
 public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"), Category = "ShoulderBash")
-		class UBoxComponent* BashTrigger;
+		class UBoxComponent* BashTrigger; // Shape swept by the bash trace
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "ShoulderBash")
+		class UMeleeTraceComponent* BashTrace; // Sweeps the shoulder bash trigger box during the bash
 
 	UFUNCTION(BlueprintCallable, Category = "ShoulderBash")
-		void BeginBashAttack(); // Activate shoulder bash trigger box
+		void BeginBashAttack(); // Start sweeping shoulder bash trigger box
 	UFUNCTION(BlueprintCallable, Category = "ShoulderBash")
-		void EndBashAttack(); // Deactivate shoulder bash trigget box
+		void EndBashAttack(); // Stop sweeping shoulder bash trigger box
 
 	UFUNCTION(BlueprintCallable, Category = "ShoulderBash")
 		void BeginBashMovement(); // Begin bash movement
 	UFUNCTION(BlueprintCallable, Category = "ShoulderBash")
 		void EndShoulderBash(); // End shoulder bash movement and reset values
 
-	UPROPERTY(BlueprintReadOnly)
-		float CurrentBashCooldown = 0.0f;
+	UPROPERTY(BlueprintReadOnly, BlueprintGetter = GetCurrentBashCooldown)
+		float CurrentBashCooldown = 0.0f; // Never written, blueprints read it through the getter
+	UFUNCTION(BlueprintGetter)
+		float GetCurrentBashCooldown() const; // Seconds left of shoulder bash cooldown
 
 private:
 	UPROPERTY(EditAnywhere, Category = "ShoulderBash")
@@ -111,26 +115,32 @@ private:
 
 	void ShoulderBashAction(); // input
 	void BeginShoulderBash(); // trigger shoulder bash
-	void BashMovement(float DeltaSeconds); // handles ability's movement
+	void BashMovement(float DeltaSeconds); // handles ability's movement, ticked while moving with bash
 	void EndBashMovement(); // ends bash movement and resets values
 
 	FVector BashDirection;
 
-	UFUNCTION()
-		void OnShoulderBashBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	void OnShoulderBashHits(const TArray<AActor*>& HitActors); // Damage, knockback and destroy the actors hit by the bash
 
 	UPROPERTY(EditAnywhere, Category = "ShoulderBash")
 		float BashCooldown = 2.0f;
-	void TickBashCooldown(float DeltaSeconds);
+	FCooldownHandle BashCooldownHandle;
+
+	// Ability handles
+	int32 BashMovementAbility = INDEX_NONE;
 
 
 
 	// _____BOOSTS_____
 public:
-	UPROPERTY(BlueprintReadOnly)
-		float CurrentLifeStealCooldown;
-	UPROPERTY(BlueprintReadOnly)
-		float CurrentBerserkCooldown;
+	UPROPERTY(BlueprintReadOnly, BlueprintGetter = GetCurrentLifeStealCooldown)
+		float CurrentLifeStealCooldown = 0.0f; // Never written, blueprints read it through the getter
+	UPROPERTY(BlueprintReadOnly, BlueprintGetter = GetCurrentBerserkCooldown)
+		float CurrentBerserkCooldown = 0.0f; // Never written, blueprints read it through the getter
+	UFUNCTION(BlueprintGetter)
+		float GetCurrentLifeStealCooldown() const; // Seconds left of lifesteal boost cooldown
+	UFUNCTION(BlueprintGetter)
+		float GetCurrentBerserkCooldown() const; // Seconds left of berserk boost cooldown
 
 protected:
 	UPROPERTY(BlueprintReadWrite)
@@ -147,12 +157,13 @@ private:
 
 	UPROPERTY(EditAnywhere, Category = "LifeStealBoost")
 		float LifeStealDuration = 2.0f;
-	float CurrentLifeStealDuration;
+	FCooldownHandle LifeStealDurationHandle;
 
 	UPROPERTY(EditAnywhere, Category = "LifeStealBoost")
 		float LifeStealCooldown = 2.0f;
+	FCooldownHandle LifeStealCooldownHandle;
 
-	void TickLifeSteal(float DeltaSeconds); // Ticks lifesteal boost duration and cooldown
+	void EndLifeSteal(); // Ends lifesteal boost and starts its cooldown
 
 	UPROPERTY(EditAnywhere, Category = "BerserkBoost")
 		float DamageBoost = 10.0f; // Berserk boost's extra damage points
@@ -163,10 +174,11 @@ private:
 
 	UPROPERTY(EditAnywhere, Category = "BerserkBoost")
 		float BerserkDuration = 2.0f;
-	float CurrentBerserkDuration;
+	FCooldownHandle BerserkDurationHandle;
 
 	UPROPERTY(EditAnywhere, Category = "BerserkBoost")
 		float BerserkCooldown = 2.0f;
+	FCooldownHandle BerserkCooldownHandle;
 
-	void TickBerserkBoost(float DeltaSeconds); // Ticks berserk boost duration and cooldown
+	void EndBerserkBoost(); // Ends berserk boost, resetting damage, and starts its cooldown
 };
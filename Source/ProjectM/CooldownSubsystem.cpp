@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CooldownSubsystem.h"
+#include "ProjectM.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cooldown wheel"), STAT_VenariCooldownWheel, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active cooldowns"), STAT_VenariActiveCooldowns, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Expired cooldowns"), STAT_VenariExpiredCooldowns, STATGROUP_Venari);
+
+void UCooldownSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Buckets.SetNum(NumBuckets);
+	CurrentTick = TimeToTick(GetTime());
+}
+
+void UCooldownSubsystem::Deinitialize()
+{
+	Timers.Reset();
+	FreeTimers.Reset();
+	Buckets.Reset();
+	ExpiredCallbacks.Reset();
+
+	Super::Deinitialize();
+}
+
+ETickableTickType UCooldownSubsystem::GetTickableTickType() const
+{
+	// Never tick the class default object
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UCooldownSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCooldownSubsystem, STATGROUP_Tickables);
+}
+
+float UCooldownSubsystem::GetTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0f;
+}
+
+int64 UCooldownSubsystem::TimeToTick(float Time) const
+{
+	return (int64)FMath::FloorToDouble((double)Time * TicksPerSecond);
+}
+
+FCooldownHandle UCooldownSubsystem::StartCooldown(float Duration, FCooldownExpiredDelegate OnExpired)
+{
+	int32 TimerIndex;
+	if (FreeTimers.Num() > 0)
+		TimerIndex = FreeTimers.Pop(false);
+	else
+		TimerIndex = Timers.AddDefaulted();
+
+	FCooldownTimer& Timer = Timers[TimerIndex];
+	Timer.ExpiryTime = GetTime() + FMath::Max(Duration, 0.0f);
+	Timer.ExpiryTick = (int64)FMath::CeilToDouble((double)Timer.ExpiryTime * TicksPerSecond);
+	Timer.OnExpired = MoveTemp(OnExpired);
+	InsertTimer(TimerIndex);
+
+	FCooldownHandle Handle;
+	Handle.Index = TimerIndex;
+	Handle.Generation = Timer.Generation;
+	return Handle;
+}
+
+void UCooldownSubsystem::RestartCooldown(FCooldownHandle& Handle, float Duration, FCooldownExpiredDelegate OnExpired)
+{
+	CancelCooldown(Handle);
+	Handle = StartCooldown(Duration, MoveTemp(OnExpired));
+}
+
+void UCooldownSubsystem::CancelCooldown(FCooldownHandle& Handle)
+{
+	if (IsHandleValid(Handle))
+	{
+		RemoveTimer(Handle.Index);
+		FreeTimer(Handle.Index);
+	}
+
+	Handle.Invalidate();
+}
+
+bool UCooldownSubsystem::IsHandleValid(const FCooldownHandle& Handle) const
+{
+	return Timers.IsValidIndex(Handle.Index) && Timers[Handle.Index].Generation == Handle.Generation
+		&& Timers[Handle.Index].Bucket != INDEX_NONE;
+}
+
+bool UCooldownSubsystem::IsCooldownActive(const FCooldownHandle& Handle) const
+{
+	return IsHandleValid(Handle) && Timers[Handle.Index].ExpiryTime > GetTime();
+}
+
+float UCooldownSubsystem::GetRemainingTime(const FCooldownHandle& Handle) const
+{
+	if (!IsHandleValid(Handle))
+		return 0.0f;
+
+	return FMath::Max(Timers[Handle.Index].ExpiryTime - GetTime(), 0.0f);
+}
+
+// Wheel bucket for the tick, depending on how far ahead of the current tick it is
+int32 UCooldownSubsystem::GetBucket(int64 ExpiryTick) const
+{
+	const int64 Delta = ExpiryTick - CurrentTick;
+
+	if (Delta < Level0Slots)
+		return (int32)(ExpiryTick & (Level0Slots - 1));
+
+	if (Delta < ((int64)1 << (Level0Bits + Level1Bits)))
+		return Level0Slots + (int32)((ExpiryTick >> Level0Bits) & (Level1Slots - 1));
+
+	if (Delta < ((int64)1 << (Level0Bits + Level1Bits + Level2Bits)))
+		return Level0Slots + Level1Slots + (int32)((ExpiryTick >> (Level0Bits + Level1Bits)) & (Level2Slots - 1));
+
+	return OverflowBucket;
+}
+
+void UCooldownSubsystem::InsertTimer(int32 TimerIndex)
+{
+	FCooldownTimer& Timer = Timers[TimerIndex];
+
+	// Timers that are already due fire on the next processed tick
+	Timer.ExpiryTick = FMath::Max(Timer.ExpiryTick, CurrentTick + 1);
+	Timer.Bucket = GetBucket(Timer.ExpiryTick);
+	Timer.BucketSlot = Buckets[Timer.Bucket].Add(TimerIndex);
+}
+
+void UCooldownSubsystem::RemoveTimer(int32 TimerIndex)
+{
+	FCooldownTimer& Timer = Timers[TimerIndex];
+	TArray<int32>& Bucket = Buckets[Timer.Bucket];
+
+	// Swap remove, fixing up the slot of the timer moved into place
+	const int32 Slot = Timer.BucketSlot;
+	Bucket.RemoveAtSwap(Slot, 1, false);
+	if (Bucket.IsValidIndex(Slot))
+		Timers[Bucket[Slot]].BucketSlot = Slot;
+
+	Timer.Bucket = INDEX_NONE;
+	Timer.BucketSlot = INDEX_NONE;
+}
+
+void UCooldownSubsystem::FreeTimer(int32 TimerIndex)
+{
+	FCooldownTimer& Timer = Timers[TimerIndex];
+	Timer.Generation++;
+	Timer.OnExpired.Unbind();
+	FreeTimers.Add(TimerIndex);
+}
+
+void UCooldownSubsystem::Cascade(int32 Bucket)
+{
+	TArray<int32> Cascaded = MoveTemp(Buckets[Bucket]);
+	Buckets[Bucket].Reset();
+
+	for (int32 TimerIndex : Cascaded)
+		InsertTimer(TimerIndex);
+}
+
+void UCooldownSubsystem::AdvanceTo(int64 Tick)
+{
+	while (CurrentTick < Tick)
+	{
+		CurrentTick++;
+
+		// When a level wraps around, move the timers of its next slot down a level
+		if ((CurrentTick & (Level0Slots - 1)) == 0)
+		{
+			const int64 Level1Tick = CurrentTick >> Level0Bits;
+			if ((Level1Tick & (Level1Slots - 1)) == 0)
+			{
+				const int64 Level2Tick = Level1Tick >> Level1Bits;
+				if ((Level2Tick & (Level2Slots - 1)) == 0)
+					Cascade(OverflowBucket);
+
+				Cascade(Level0Slots + Level1Slots + (int32)(Level2Tick & (Level2Slots - 1)));
+			}
+
+			Cascade(Level0Slots + (int32)(Level1Tick & (Level1Slots - 1)));
+		}
+
+		// Every timer left in this level 0 slot expires on this tick
+		TArray<int32>& Expired = Buckets[(int32)(CurrentTick & (Level0Slots - 1))];
+		for (int32 TimerIndex : Expired)
+		{
+			FCooldownTimer& Timer = Timers[TimerIndex];
+			Timer.Bucket = INDEX_NONE;
+			Timer.BucketSlot = INDEX_NONE;
+
+			if (Timer.OnExpired.IsBound())
+				ExpiredCallbacks.Add(MoveTemp(Timer.OnExpired));
+
+			FreeTimer(TimerIndex);
+		}
+		Expired.Reset();
+	}
+}
+
+// Advance the wheel to the current world time and fire the expired callbacks
+void UCooldownSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VenariCooldownWheel);
+
+	// Only fully elapsed ticks are processed and expiry ticks are rounded up, so cooldowns fire up to a tick late, never early
+	AdvanceTo(TimeToTick(GetTime()));
+
+	INC_DWORD_STAT_BY(STAT_VenariExpiredCooldowns, ExpiredCallbacks.Num());
+	SET_DWORD_STAT(STAT_VenariActiveCooldowns, GetNumActiveCooldowns());
+
+	// Callbacks may start new cooldowns, so they are only called once the wheel is done
+	for (FCooldownExpiredDelegate& Callback : ExpiredCallbacks)
+		Callback.ExecuteIfBound();
+
+	ExpiredCallbacks.Reset();
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "CooldownSubsystem.generated.h"
+
+DECLARE_DELEGATE(FCooldownExpiredDelegate);
+
+/**
+ * Handle to a cooldown started in UCooldownSubsystem, stays valid until the cooldown expires or is cancelled
+ */
+struct FCooldownHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+/**
+ * Cooldowns and timers of every actor in the world, keyed on world time.
+ * Cooldowns are stored as expiry timestamps, so checking one is a single compare,
+ * and a hierarchical timing wheel fires their expiry callbacks in batch once per frame.
+ */
+UCLASS()
+class PROJECTM_API UCooldownSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	// Start a cooldown of the given duration, OnExpired is called once it ends
+	FCooldownHandle StartCooldown(float Duration, FCooldownExpiredDelegate OnExpired = FCooldownExpiredDelegate());
+	// Cancel the cooldown the handle points to, if any, and start a new one in it
+	void RestartCooldown(FCooldownHandle& Handle, float Duration, FCooldownExpiredDelegate OnExpired = FCooldownExpiredDelegate());
+	// Stop the cooldown without calling its expiry callback
+	void CancelCooldown(FCooldownHandle& Handle);
+
+	bool IsCooldownActive(const FCooldownHandle& Handle) const;
+	float GetRemainingTime(const FCooldownHandle& Handle) const; // 0 if the cooldown isn't active
+	float GetTime() const; // World time cooldowns are keyed on
+
+	int32 GetNumActiveCooldowns() const { return Timers.Num() - FreeTimers.Num(); }
+
+private:
+	// Wheel levels, level 0 slots are one tick wide and every slot of a level spans a full turn of the level below
+	static constexpr int32 TicksPerSecond = 60;
+	static constexpr int32 Level0Bits = 8;
+	static constexpr int32 Level1Bits = 6;
+	static constexpr int32 Level2Bits = 6;
+	static constexpr int32 Level0Slots = 1 << Level0Bits;
+	static constexpr int32 Level1Slots = 1 << Level1Bits;
+	static constexpr int32 Level2Slots = 1 << Level2Bits;
+	static constexpr int32 OverflowBucket = Level0Slots + Level1Slots + Level2Slots; // Timers beyond the last level, re-checked every turn of it
+	static constexpr int32 NumBuckets = OverflowBucket + 1;
+
+	struct FCooldownTimer
+	{
+		float ExpiryTime = 0.0f; // World time at which the cooldown ends
+		int64 ExpiryTick = 0;
+		uint32 Generation = 0;
+		int32 Bucket = INDEX_NONE; // Wheel bucket holding the timer, none while the timer is free
+		int32 BucketSlot = INDEX_NONE; // Index of the timer inside its bucket
+		FCooldownExpiredDelegate OnExpired;
+	};
+
+	bool IsHandleValid(const FCooldownHandle& Handle) const;
+	int64 TimeToTick(float Time) const;
+	int32 GetBucket(int64 ExpiryTick) const;
+	void InsertTimer(int32 TimerIndex);
+	void RemoveTimer(int32 TimerIndex);
+	void FreeTimer(int32 TimerIndex);
+	void Cascade(int32 Bucket); // Re-insert every timer in the bucket, moving them down a level
+	void AdvanceTo(int64 Tick); // Process every tick up to the given one, gathering expired timers
+
+	TArray<FCooldownTimer> Timers; // Compact timer storage, indexed by handle
+	TArray<int32> FreeTimers; // Free timer indices to be reused
+	TArray<TArray<int32>> Buckets; // Timer indices per wheel slot
+	int64 CurrentTick = 0; // Last processed tick
+
+	TArray<FCooldownExpiredDelegate> ExpiredCallbacks; // Callbacks of the timers expired this frame, called in batch
+};
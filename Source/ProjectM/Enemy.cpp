@@ -10,57 +10,106 @@
 #include "Components/CapsuleComponent.h"
 #include "AIController.h"
 #include "BrainComponent.h"
+#include "EnemyManagerSubsystem.h"
+#include "ActorPoolSubsystem.h"
+#include "CooldownSubsystem.h"
+#include "MeleeTraceComponent.h"
+#include "ActorCategoryComponent.h"
+#include "ActorCategorySubsystem.h"
+#include "QuestSubsystem.h"
 
 // Sets default values
 AEnemy::AEnemy()
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Combat state is updated in batch by the enemy manager, nothing to do every frame
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create health component
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
 
+	// Create category component
+	CategoryComponent = CreateDefaultSubobject<UActorCategoryComponent>(TEXT("CategoryComponent"));
+
 	// Create melee trigger box
 	MeleeTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("Melee Trigger"));
 	MeleeTrigger->SetupAttachment(RootComponent);
 	MeleeTrigger->bEditableWhenInherited = true;
+
+	// Create melee trace component
+	MeleeTrace = CreateDefaultSubobject<UMeleeTraceComponent>(TEXT("MeleeTrace"));
 }
 
 // Called when the game starts or when spawned
 void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
-	MeleeTrigger->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnMeleeBoxBeginOverlap);
+
+	// Melee trigger is only swept, it doesn't need to collide
+	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeleeTrace->SetTraceBox(MeleeTrigger);
+	MeleeTrace->OnHits.BindUObject(this, &AEnemy::OnMeleeHits);
+
+	EnemyManager = GetWorld()->GetSubsystem<UEnemyManagerSubsystem>();
+	ActorCategories = GetWorld()->GetSubsystem<UActorCategorySubsystem>();
+	EnemyManager->RegisterEnemy(this);
+	EnemyManager->SetDead(this, HealthComponent->IsDead());
 
 	EndMeleeAttack();
 
-	for (int i = 0; i < GetMesh()->GetMaterials().Num(); i++)
+	// Materials reading custom primitive data keep the shared instances and can batch
+	if (!bHPFromCustomPrimitiveData)
 	{
-		DynamicMaterials.Add(UMaterialInstanceDynamic::Create(GetMesh()->GetMaterial(i), this));
-		GetMesh()->SetMaterial(i, DynamicMaterials[i]);
+		for (int i = 0; i < GetMesh()->GetMaterials().Num(); i++)
+		{
+			DynamicMaterials.Add(UMaterialInstanceDynamic::Create(GetMesh()->GetMaterial(i), this));
+			GetMesh()->SetMaterial(i, DynamicMaterials[i]);
+		}
 	}
 
-	CurrentMeleeCooldown = MeleeCooldown;
+	UpdateHPMaterials();
+
+	DefaultCapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
 }
 
-void AEnemy::DeactivateAI()
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (EnemyManager)
+		EnemyManager->UnregisterEnemy(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UBrainComponent* AEnemy::GetBrainComponent() const
 {
 	AAIController* AIController = Cast<AAIController>(GetController());
 
 	if (AIController == nullptr)
-		return;
+		return nullptr;
 
-	AIController->GetBrainComponent()->StopLogic(TEXT("Character is dead."));
+	return AIController->GetBrainComponent();
 }
 
-void AEnemy::OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::DeactivateAI()
 {
-	APlayerCharacter* Player = Cast<APlayerCharacter>(OtherActor);
+	UBrainComponent* Brain = GetBrainComponent();
 
-	if (Player == nullptr)
+	if (Brain == nullptr)
 		return;
 
-	Player->TakeDamage(MeleeDamage);
+	Brain->StopLogic(TEXT("Character is dead."));
+}
+
+void AEnemy::OnMeleeHits(const TArray<AActor*>& HitActors)
+{
+	for (AActor* OtherActor : HitActors)
+	{
+		APlayerCharacter* Player = ActorCategories->GetPlayer(OtherActor);
+
+		if (Player == nullptr)
+			continue;
+
+		Player->TakeDamage(MeleeDamage);
+	}
 }
 
 void AEnemy::TakeDamage(float Amount)
@@ -71,17 +120,19 @@ void AEnemy::TakeDamage(float Amount)
 		return;
 
 	HealthComponent->TakeDamage(Amount);
+	EnemyManager->SetDead(this, HealthComponent->IsDead());
+	EnemyManager->MarkHit(this);
 
-	for (int i = 0; i < DynamicMaterials.Num(); i++)
-	{
-		DynamicMaterials[i]->SetScalarParameterValue("HP Percentage", HealthComponent->GetHPRatio());
-	}
+	UpdateHPMaterials();
 
 	if (HealthComponent->IsDead())
 	{
 		DeactivateAI();
 
-		SoundManager::PlayRandomSoundAttached(DeathSfx, GetMesh(), FName("head"), SoundAttenuation);
+		if (!MonsterName.IsNone())
+			GetGameInstance()->GetSubsystem<UQuestSubsystem>()->RecordEvent(EQuestEventType::KILL, MonsterName);
+
+		GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAttached(DeathSfx, GetMesh(), FName("head"), SoundAttenuation);
 		
 		if (DeathAnimations.Num() <= 0)
 		{
@@ -97,6 +148,11 @@ void AEnemy::TakeDamage(float Amount)
 
 		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		GetCapsuleComponent()->Deactivate();
+
+		// Pooled enemies return to the pool once their corpse has been around for a while
+		if (GetWorld()->GetSubsystem<UActorPoolSubsystem>()->IsPooled(this))
+			GetWorld()->GetSubsystem<UCooldownSubsystem>()->StartCooldown(CorpseLifetime,
+				FCooldownExpiredDelegate::CreateUObject(this, &AEnemy::ReleaseCorpse));
 	}
 	else
 	{
@@ -105,18 +161,10 @@ void AEnemy::TakeDamage(float Amount)
 			GetMesh()->GetAnimInstance()->Montage_Play(DamageAnimation);
 		}
 
-		SoundManager::PlayRandomSoundAtLocation(GetWorld(), DamagedSfx, GetActorLocation(), SoundAttenuation);
+		GetWorld()->GetSubsystem<USoundManager>()->QueueRandomSoundAtLocation(DamagedSfx, GetActorLocation(), SoundAttenuation);
 	}
 }
 
-// Called every frame
-void AEnemy::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	TickMeleeCooldown(DeltaTime);
-}
-
 void AEnemy::UpdateWalkSpeed(float Value)
 {
 	GetCharacterMovement()->MaxWalkSpeed = Value;
@@ -136,25 +184,71 @@ void AEnemy::MeleeAttackAction()
 
 void AEnemy::BeginMeleeAttack()
 {
-	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	SoundManager::PlayRandomSoundAtLocation(GetWorld(), MeleeSfx, GetActorLocation(), SoundAttenuation);
+	MeleeTrace->BeginSwing();
+	GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(MeleeSfx, GetActorLocation(), SoundAttenuation);
 }
 
 void AEnemy::EndMeleeAttack()
 {
-	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	CurrentMeleeCooldown = MeleeCooldown;
+	MeleeTrace->EndSwing();
+	EnemyManager->StartMeleeCooldown(this, MeleeCooldown);
 }
 
 bool AEnemy::IsInMeleeCooldown()
 {
-	return CurrentMeleeCooldown > 0.0f;
+	return EnemyManager->IsInMeleeCooldown(this);
 }
 
-void AEnemy::TickMeleeCooldown(float DeltaTime)
+void AEnemy::UpdateHPMaterials()
 {
-	if (!IsInMeleeCooldown())
+	if (bHPFromCustomPrimitiveData)
+	{
+		GetMesh()->SetCustomPrimitiveDataFloat(HPPercentagePrimitiveDataIndex, HealthComponent->GetHPRatio());
 		return;
+	}
+
+	for (int i = 0; i < DynamicMaterials.Num(); i++)
+	{
+		DynamicMaterials[i]->SetScalarParameterValue("HP Percentage", HealthComponent->GetHPRatio());
+	}
+}
+
+void AEnemy::ReleaseCorpse()
+{
+	GetWorld()->GetSubsystem<UActorPoolSubsystem>()->Release(this);
+}
+
+// Revive with full health, collision, movement and logic
+void AEnemy::OnAcquiredFromPoolCPP()
+{
+	HealthComponent->ResetHealth();
+	UpdateHPMaterials();
+
+	GetCapsuleComponent()->Activate();
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultCapsuleCollision);
+	GetCharacterMovement()->SetDefaultMovementMode();
+	GetMesh()->GetAnimInstance()->StopAllMontages(0.0f);
+
+	EnemyManager->RegisterEnemy(this);
+	EnemyManager->SetDead(this, HealthComponent->IsDead());
+	EndMeleeAttack();
+
+	if (UBrainComponent* Brain = GetBrainComponent())
+		Brain->RestartLogic();
+}
+
+// Stop logic, movement and animations, the pool hides the actor
+void AEnemy::OnReleasedToPoolCPP()
+{
+	if (UBrainComponent* Brain = GetBrainComponent())
+		Brain->StopLogic(TEXT("Released to pool."));
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetMesh()->GetAnimInstance()->StopAllMontages(0.0f);
+	MeleeTrace->EndSwing();
+
+	EnemyManager->UnregisterEnemy(this);
 
-	CurrentMeleeCooldown -= DeltaTime;
+	OnReleasedToPool.Broadcast(this);
 }
\ No newline at end of file
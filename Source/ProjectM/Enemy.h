@@ -4,11 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "PoolableInterface.h"
 #include "Enemy.generated.h"
 
 class UAnimMontage;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FEnemyReleasedDelegate, class AEnemy*);
+
 UCLASS()
-class PROJECTM_API AEnemy : public ACharacter
+class PROJECTM_API AEnemy : public ACharacter, public IPoolableInterface
 {
 	GENERATED_BODY()
 
@@ -16,18 +20,23 @@ public:
 	// Sets default values for this character's properties
 	AEnemy();
 
+	static constexpr int32 HPPercentagePrimitiveDataIndex = 0; // Custom primitive data slot of the materials' "HP Percentage" parameter
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 		class UHealthComponent* HealthComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+		class UActorCategoryComponent* CategoryComponent; // Categorizes the character as an enemy
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* MeleeTrigger;
+		class UBoxComponent* MeleeTrigger; // Shape swept by the melee trace
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+		class UMeleeTraceComponent* MeleeTrace; // Sweeps the melee trigger box during attacks
 
 	UFUNCTION(BlueprintCallable)
 		void UpdateWalkSpeed(float Value);
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	UFUNCTION(BlueprintImplementableEvent)
 		void Knockback(FVector Force);
 
@@ -37,9 +46,19 @@ public:
 	UFUNCTION(BlueprintCallable)
 		virtual void MeleeAttackAction();
 
+	// IPoolableInterface
+	virtual void OnAcquiredFromPoolCPP() override; // Revive with full health, collision, movement and logic
+	virtual void OnReleasedToPoolCPP() override; // Stop logic, movement and animations
+
+	FEnemyReleasedDelegate OnReleasedToPool; // Broadcast when the enemy is returned to its pool
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	class UEnemyManagerSubsystem* EnemyManager = nullptr; // Holds the enemy's combat state, updated in batch with every other enemy
+	class UActorCategorySubsystem* ActorCategories = nullptr; // Category bitmasks of the world's actors
 
 	UFUNCTION(BlueprintCallable)
 		virtual void BeginMeleeAttack();
@@ -54,8 +73,7 @@ protected:
 		bool IsInMeleeCooldown();
 
 private:
-	UFUNCTION()
-		virtual void OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	virtual void OnMeleeHits(const TArray<AActor*>& HitActors); // Damage the players hit by the attack
 
 	UPROPERTY(EditDefaultsOnly)
 		TArray<UAnimMontage*> MeleeAttackAnimations;
@@ -69,6 +87,9 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Combat")
 		float MeleeDamage = 10.0f;
 
+	UPROPERTY(EditAnywhere, Category = "Quest")
+		FName MonsterName; // Kills are recorded for quests under this name, not recorded if none
+
 	UPROPERTY(EditAnywhere, Category = "SFX")
 		TArray<USoundBase*> MeleeSfx;
 
@@ -78,13 +99,24 @@ private:
 	UPROPERTY(EditAnywhere, Category = "SFX")
 		TArray<USoundBase*> DeathSfx;
 
-	TArray<UMaterialInstanceDynamic*> DynamicMaterials;
+	UPROPERTY(EditDefaultsOnly, Category = "HP Materials")
+		bool bHPFromCustomPrimitiveData = false; // Only once the materials' "HP Percentage" parameter uses custom primitive data index 0
+
+	TArray<UMaterialInstanceDynamic*> DynamicMaterials; // Per enemy instances of the mesh's materials, unless reading custom primitive data
+	void UpdateHPMaterials(); // Set HP percentage on the dynamic materials or the mesh's custom primitive data
 	
 	void DeactivateAI();
+	class UBrainComponent* GetBrainComponent() const;
+
+	ECollisionEnabled::Type DefaultCapsuleCollision; // Capsule collision to restore when revived from the pool
+
+	UPROPERTY(EditAnywhere, Category = "Pool")
+		float CorpseLifetime = 10.0f; // Seconds a pooled enemy's corpse stays before it's returned to the pool
+	void ReleaseCorpse();
 
 	UPROPERTY(EditAnywhere)
 		float MeleeCooldown = 2.0f;
-	float CurrentMeleeCooldown;
 
-	void TickMeleeCooldown(float DeltaTime);
+	friend class UEnemyManagerSubsystem;
+	int32 EnemyManagerIndex = INDEX_NONE; // Index of the enemy's state in the enemy manager
 };
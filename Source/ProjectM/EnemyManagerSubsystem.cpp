@@ -0,0 +1,311 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyManagerSubsystem.h"
+#include "ProjectM.h"
+#include "Enemy.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy manager update"), STAT_VenariEnemyManagerUpdate, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Managed enemies"), STAT_VenariManagedEnemies, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Alive enemies"), STAT_VenariAliveEnemies, STATGROUP_Venari);
+DECLARE_CYCLE_STAT(TEXT("Enemy significance"), STAT_VenariEnemySignificance, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Engaged enemies"), STAT_VenariEngagedEnemies, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visible enemies"), STAT_VenariVisibleEnemies, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Distant enemies"), STAT_VenariDistantEnemies, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dormant enemies"), STAT_VenariDormantEnemies, STATGROUP_Venari);
+
+static TAutoConsoleVariable<int32> CVarEnemySignificance(
+	TEXT("Venari.EnemySignificance"),
+	1,
+	TEXT("If 0, every enemy is treated as engaged and updates at full rate."));
+
+/**
+ * Update settings applied to enemies in a significance bucket, 0 tick interval ticks every frame
+ * Enemy actors don't tick, their mesh, movement and AI controller are throttled instead
+ * Behavior trees schedule their own tick interval, so their logic is only paused, not throttled
+ */
+struct FEnemySignificanceSettings
+{
+	float MeshTickInterval;
+	float MovementTickInterval;
+	float ControllerTickInterval;
+	bool bPauseBrain;
+	bool bAnimUpdateRateOptimizations;
+	bool bKeepDefaultAnimTickOption; // Otherwise only tick pose when rendered
+};
+
+static const FEnemySignificanceSettings SignificanceSettings[(uint8)EEnemySignificance::MAX] =
+{
+	/* ENGAGED */ { 0.0f, 0.0f, 0.0f, false, false, true },
+	/* VISIBLE */ { 0.0f, 0.0f, 0.0f, false, true, true },
+	/* DISTANT */ { 0.1f, 1.0f / 30.0f, 0.2f, false, true, false },
+	/* DORMANT */ { 0.5f, 0.25f, 0.0f, true, true, false },
+};
+
+void UEnemyManagerSubsystem::Deinitialize()
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+			Enemy->EnemyManagerIndex = INDEX_NONE;
+	}
+
+	Enemies.Reset();
+	MeleeCooldownEndTimes.Reset();
+	DeadFlags.Reset();
+	LastHitTimes.Reset();
+	TimeSinceLastHit.Reset();
+	NumAlive = 0;
+	Significance.Reset();
+	SignificanceLocations.Reset();
+	RecentlyRenderedFlags.Reset();
+	DefaultAnimTickOptions.Reset();
+	DefaultUpdateRateOptimizations.Reset();
+	FMemory::Memzero(SignificanceCounts);
+
+	Super::Deinitialize();
+}
+
+ETickableTickType UEnemyManagerSubsystem::GetTickableTickType() const
+{
+	// Never tick the class default object
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UEnemyManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyManagerSubsystem, STATGROUP_Tickables);
+}
+
+float UEnemyManagerSubsystem::GetTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0f;
+}
+
+bool UEnemyManagerSubsystem::IsManaged(const AEnemy* Enemy) const
+{
+	return Enemy && Enemies.IsValidIndex(Enemy->EnemyManagerIndex) && Enemies[Enemy->EnemyManagerIndex] == Enemy;
+}
+
+void UEnemyManagerSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (!Enemy || IsManaged(Enemy))
+		return;
+
+	Enemy->EnemyManagerIndex = Enemies.Add(Enemy);
+	MeleeCooldownEndTimes.Add(0.0f);
+	DeadFlags.Add(false);
+	LastHitTimes.Add(-1.0f);
+	TimeSinceLastHit.Add(BIG_NUMBER);
+	NumAlive++;
+
+	// Enemies start engaged, with the mesh settings they were spawned with
+	Significance.Add(EEnemySignificance::ENGAGED);
+	SignificanceLocations.Add(Enemy->GetActorLocation());
+	RecentlyRenderedFlags.Add(true);
+	DefaultAnimTickOptions.Add(Enemy->GetMesh()->VisibilityBasedAnimTickOption);
+	DefaultUpdateRateOptimizations.Add(Enemy->GetMesh()->bEnableUpdateRateOptimizations);
+	SignificanceCounts[(uint8)EEnemySignificance::ENGAGED]++;
+}
+
+// Swap remove the enemy's state, fixing up the index of the enemy moved into its place
+void UEnemyManagerSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (!IsManaged(Enemy))
+		return;
+
+	const int32 Index = Enemy->EnemyManagerIndex;
+	if (!DeadFlags[Index])
+		NumAlive--;
+
+	// Leave the enemy with full rate settings, it can be registered again when reused from a pool
+	SignificanceCounts[(uint8)Significance[Index]]--;
+	if (Significance[Index] != EEnemySignificance::ENGAGED)
+	{
+		Significance[Index] = EEnemySignificance::ENGAGED;
+		ApplySignificance(Index);
+	}
+
+	Enemies.RemoveAtSwap(Index, 1, false);
+	MeleeCooldownEndTimes.RemoveAtSwap(Index, 1, false);
+	DeadFlags.RemoveAtSwap(Index, 1, false);
+	LastHitTimes.RemoveAtSwap(Index, 1, false);
+	TimeSinceLastHit.RemoveAtSwap(Index, 1, false);
+	Significance.RemoveAtSwap(Index, 1, false);
+	SignificanceLocations.RemoveAtSwap(Index, 1, false);
+	RecentlyRenderedFlags.RemoveAtSwap(Index, 1, false);
+	DefaultAnimTickOptions.RemoveAtSwap(Index, 1, false);
+	DefaultUpdateRateOptimizations.RemoveAtSwap(Index, 1, false);
+
+	if (Enemies.IsValidIndex(Index))
+		Enemies[Index]->EnemyManagerIndex = Index;
+
+	Enemy->EnemyManagerIndex = INDEX_NONE;
+}
+
+void UEnemyManagerSubsystem::StartMeleeCooldown(const AEnemy* Enemy, float Duration)
+{
+	if (!IsManaged(Enemy))
+		return;
+
+	MeleeCooldownEndTimes[Enemy->EnemyManagerIndex] = GetTime() + Duration;
+}
+
+void UEnemyManagerSubsystem::SetDead(const AEnemy* Enemy, bool bDead)
+{
+	if (!IsManaged(Enemy))
+		return;
+
+	const int32 Index = Enemy->EnemyManagerIndex;
+	if (DeadFlags[Index] != (uint8)bDead)
+		NumAlive += bDead ? -1 : 1;
+	DeadFlags[Index] = bDead;
+}
+
+void UEnemyManagerSubsystem::MarkHit(const AEnemy* Enemy)
+{
+	if (!IsManaged(Enemy))
+		return;
+
+	LastHitTimes[Enemy->EnemyManagerIndex] = GetTime();
+	TimeSinceLastHit[Enemy->EnemyManagerIndex] = 0.0f;
+}
+
+bool UEnemyManagerSubsystem::IsInMeleeCooldown(const AEnemy* Enemy) const
+{
+	return IsManaged(Enemy) && GetTime() < MeleeCooldownEndTimes[Enemy->EnemyManagerIndex];
+}
+
+float UEnemyManagerSubsystem::GetTimeSinceLastHit(const AEnemy* Enemy) const
+{
+	return IsManaged(Enemy) ? TimeSinceLastHit[Enemy->EnemyManagerIndex] : BIG_NUMBER;
+}
+
+EEnemySignificance UEnemyManagerSubsystem::GetSignificance(const AEnemy* Enemy) const
+{
+	return IsManaged(Enemy) ? Significance[Enemy->EnemyManagerIndex] : EEnemySignificance::ENGAGED;
+}
+
+// Refresh the per frame state of every enemy in one pass
+void UEnemyManagerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VenariEnemyManagerUpdate);
+
+	const int32 NumEnemies = Enemies.Num();
+	SET_DWORD_STAT(STAT_VenariManagedEnemies, NumEnemies);
+	SET_DWORD_STAT(STAT_VenariAliveEnemies, NumAlive);
+
+	if (NumEnemies == 0)
+		return;
+
+	const float Now = GetTime();
+	// A subtraction per enemy, too little work to pay for a parallel dispatch
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+		TimeSinceLastHit[Index] = LastHitTimes[Index] < 0.0f ? BIG_NUMBER : Now - LastHitTimes[Index];
+
+	if (Now >= NextSignificanceUpdateTime)
+	{
+		NextSignificanceUpdateTime = Now + SignificanceUpdateInterval;
+		UpdateSignificance();
+	}
+}
+
+void UEnemyManagerSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VenariEnemySignificance);
+
+	const int32 NumEnemies = Enemies.Num();
+
+	// Significance is measured from the player's view
+	FVector ViewLocation = FVector::ZeroVector;
+	FRotator ViewRotation;
+	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+	const bool bEnabled = CVarEnemySignificance.GetValueOnGameThread() != 0 && PlayerController != nullptr;
+	if (PlayerController)
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	// Gather what's needed from the actors on the game thread
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+	{
+		SignificanceLocations[Index] = Enemies[Index]->GetActorLocation();
+		RecentlyRenderedFlags[Index] = Enemies[Index]->WasRecentlyRendered(RenderedTolerance);
+	}
+
+	// Bucket into a scratch array, settings are only applied to enemies that changed bucket
+	TArray<EEnemySignificance> NewSignificance;
+	NewSignificance.SetNumUninitialized(NumEnemies);
+
+	const FVector* Locations = SignificanceLocations.GetData();
+	const uint8* Rendered = RecentlyRenderedFlags.GetData();
+	const float* SinceLastHit = TimeSinceLastHit.GetData();
+	EEnemySignificance* Buckets = NewSignificance.GetData();
+
+	ParallelFor(NumEnemies, [=](int32 Index)
+	{
+		const float DistanceSquared = FVector::DistSquared(Locations[Index], ViewLocation);
+
+		if (!bEnabled || DistanceSquared < FMath::Square(EngagedDistance) || SinceLastHit[Index] < EngagedHitTime)
+			Buckets[Index] = EEnemySignificance::ENGAGED;
+		else if (Rendered[Index] && DistanceSquared < FMath::Square(VisibleDistance))
+			Buckets[Index] = EEnemySignificance::VISIBLE;
+		else if (Rendered[Index] || DistanceSquared < FMath::Square(VisibleDistance))
+			Buckets[Index] = EEnemySignificance::DISTANT;
+		else
+			Buckets[Index] = EEnemySignificance::DORMANT;
+	}, NumEnemies < MinEnemiesForParallelUpdate);
+
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+	{
+		if (NewSignificance[Index] == Significance[Index])
+			continue;
+
+		SignificanceCounts[(uint8)Significance[Index]]--;
+		SignificanceCounts[(uint8)NewSignificance[Index]]++;
+		Significance[Index] = NewSignificance[Index];
+		ApplySignificance(Index);
+	}
+
+	SET_DWORD_STAT(STAT_VenariEngagedEnemies, SignificanceCounts[(uint8)EEnemySignificance::ENGAGED]);
+	SET_DWORD_STAT(STAT_VenariVisibleEnemies, SignificanceCounts[(uint8)EEnemySignificance::VISIBLE]);
+	SET_DWORD_STAT(STAT_VenariDistantEnemies, SignificanceCounts[(uint8)EEnemySignificance::DISTANT]);
+	SET_DWORD_STAT(STAT_VenariDormantEnemies, SignificanceCounts[(uint8)EEnemySignificance::DORMANT]);
+}
+
+void UEnemyManagerSubsystem::ApplySignificance(int32 Index)
+{
+	AEnemy* Enemy = Enemies[Index];
+	const FEnemySignificanceSettings& Settings = SignificanceSettings[(uint8)Significance[Index]];
+
+	Enemy->GetCharacterMovement()->SetComponentTickInterval(Settings.MovementTickInterval);
+
+	USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	Mesh->SetComponentTickInterval(Settings.MeshTickInterval);
+	Mesh->bEnableUpdateRateOptimizations = Settings.bAnimUpdateRateOptimizations || DefaultUpdateRateOptimizations[Index];
+	Mesh->VisibilityBasedAnimTickOption = Settings.bKeepDefaultAnimTickOption ? DefaultAnimTickOptions[Index]
+		: EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+
+	AAIController* AIController = Cast<AAIController>(Enemy->GetController());
+	if (AIController == nullptr)
+		return;
+
+	AIController->SetActorTickInterval(Settings.ControllerTickInterval);
+
+	// Dead enemies have their logic stopped for good
+	UBrainComponent* Brain = AIController->GetBrainComponent();
+	if (Brain == nullptr || DeadFlags[Index])
+		return;
+
+	if (Settings.bPauseBrain && !Brain->IsPaused())
+		Brain->PauseLogic(TEXT("Enemy is dormant."));
+	else if (!Settings.bPauseBrain && Brain->IsPaused())
+		Brain->ResumeLogic(TEXT("Enemy is no longer dormant."));
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "MyEnums.h"
+#include "EnemyManagerSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Combat state of every enemy in the world, kept in struct of arrays storage.
+ * Enemies don't tick, their per frame state is refreshed here in a single pass.
+ * Enemies are also bucketed by significance (distance, screen presence and engagement),
+ * which sets how often their AI, animation and movement update.
+ */
+UCLASS()
+class PROJECTM_API UEnemyManagerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	void StartMeleeCooldown(const AEnemy* Enemy, float Duration);
+	void SetDead(const AEnemy* Enemy, bool bDead); // Called when the enemy's health changes
+	void MarkHit(const AEnemy* Enemy); // Called when the enemy gets hit
+
+	bool IsInMeleeCooldown(const AEnemy* Enemy) const; // Exact world time compare, doesn't wait for the next update
+	float GetTimeSinceLastHit(const AEnemy* Enemy) const;
+	EEnemySignificance GetSignificance(const AEnemy* Enemy) const;
+
+	int32 GetNumEnemies() const { return Enemies.Num(); }
+	int32 GetNumEnemiesWithSignificance(EEnemySignificance InSignificance) const { return SignificanceCounts[(uint8)InSignificance]; }
+
+private:
+	float GetTime() const;
+	bool IsManaged(const AEnemy* Enemy) const;
+
+	void UpdateSignificance(); // Re-bucket every enemy, applying the settings of the enemies that changed bucket
+	void ApplySignificance(int32 Index); // Set tick intervals, animation and AI state of the enemy for its bucket
+
+	UPROPERTY()
+		TArray<AEnemy*> Enemies; // Dense, an enemy's index is stored in it and fixed up on removal
+
+	// Combat state, one entry per enemy
+	TArray<float> MeleeCooldownEndTimes; // World time at which the melee cooldown ends
+	TArray<uint8> DeadFlags;
+	TArray<float> LastHitTimes; // World time of the last hit, negative if never hit
+
+	// Refreshed every frame by the update pass
+	TArray<float> TimeSinceLastHit;
+	int32 NumAlive = 0; // Reported in the stats
+
+	static constexpr int32 MinEnemiesForParallelUpdate = 64; // Below this count significance is bucketed on the game thread only
+
+	// Significance, one entry per enemy
+	TArray<EEnemySignificance> Significance;
+	TArray<FVector> SignificanceLocations; // Gathered on the game thread before bucketing
+	TArray<uint8> RecentlyRenderedFlags;
+	TArray<EVisibilityBasedAnimTickOption> DefaultAnimTickOptions; // Mesh settings to restore at full significance
+	TArray<uint8> DefaultUpdateRateOptimizations;
+	int32 SignificanceCounts[(uint8)EEnemySignificance::MAX] = {};
+	float NextSignificanceUpdateTime = 0.0f;
+
+	static constexpr float SignificanceUpdateInterval = 0.25f;
+	static constexpr float EngagedDistance = 1500.0f; // Enemies closer than this to the player's view are always engaged
+	static constexpr float EngagedHitTime = 5.0f; // Enemies hit within this many seconds are engaged
+	static constexpr float VisibleDistance = 5000.0f; // Rendered enemies within this distance update at full rate
+	static constexpr float RenderedTolerance = 0.2f; // Seconds since last render for an enemy to count as on screen
+};
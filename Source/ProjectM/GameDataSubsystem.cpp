@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameDataSubsystem.h"
+#include "VenariGameInstance.h"
+#include "Engine/DataTable.h"
+
+static const TCHAR* DefaultItemsDataPath = TEXT("/Game/02_DataTables/DT_ItemsData.DT_ItemsData");
+static const TCHAR* DefaultMonsterHintsDataPath = TEXT("/Game/02_DataTables/DT_MonsterHints.DT_MonsterHints");
+static const TCHAR* DefaultQuestsDataPath = TEXT("/Game/02_DataTables/BT_QuestInfo.BT_QuestInfo");
+static const TCHAR* DefaultLevelsDataPath = TEXT("/Game/02_DataTables/DT_LevelsData.DT_LevelsData");
+
+void UGameDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UVenariGameInstance* GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+	ItemsData = LoadTable(GameInstance ? GameInstance->ItemsDataTable : nullptr, DefaultItemsDataPath);
+	MonsterHintsData = LoadTable(GameInstance ? GameInstance->MonsterHintsDataTable : nullptr, DefaultMonsterHintsDataPath);
+	QuestsData = LoadTable(GameInstance ? GameInstance->QuestsDataTable : nullptr, DefaultQuestsDataPath);
+	LevelsData = LoadTable(GameInstance ? GameInstance->LevelsDataTable : nullptr, DefaultLevelsDataPath);
+
+	FlattenItems();
+	FlattenMonsters();
+	FlattenQuests();
+	FlattenLevels();
+}
+
+void UGameDataSubsystem::Deinitialize()
+{
+	Items.Reset();
+	Monsters.Reset();
+	Quests.Reset();
+	QuestObjectives.Reset();
+	Levels.Reset();
+	LevelRows.Reset();
+	ItemLookup.Reset();
+	MonsterLookup.Reset();
+	QuestLookup.Reset();
+	LevelLookup.Reset();
+	Texts.Reset();
+
+	ItemsData = nullptr;
+	MonsterHintsData = nullptr;
+	QuestsData = nullptr;
+	LevelsData = nullptr;
+
+	Super::Deinitialize();
+}
+
+UDataTable* UGameDataSubsystem::LoadTable(UDataTable* Table, const TCHAR* DefaultPath)
+{
+	if (!Table)
+		Table = LoadObject<UDataTable>(nullptr, DefaultPath);
+
+	if (!Table)
+		UE_LOG(LogTemp, Warning, TEXT("Game data: couldn't load %s"), DefaultPath);
+
+	return Table;
+}
+
+void UGameDataSubsystem::FlattenItems()
+{
+	if (!ItemsData)
+		return;
+
+	Items.Reserve(ItemsData->GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : ItemsData->GetRowMap())
+	{
+		const FItemStruct* Item = reinterpret_cast<const FItemStruct*>(Row.Value);
+		ItemLookup.Add(Item->Name, Items.Add(*Item));
+	}
+}
+
+void UGameDataSubsystem::FlattenMonsters()
+{
+	if (!MonsterHintsData)
+		return;
+
+	Monsters.Reserve(MonsterHintsData->GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : MonsterHintsData->GetRowMap())
+	{
+		const FMonsterHints* Hints = reinterpret_cast<const FMonsterHints*>(Row.Value);
+
+		FMonsterData& Monster = Monsters.AddDefaulted_GetRef();
+		Monster.Row = Row.Key;
+		Monster.Name = FName(*Hints->Name);
+		Monster.FootprintsHint = Hints->FootprintsHint;
+		Monster.FurHint = Hints->FurHint;
+		Monster.ResidueHint = Hints->ResidueHint;
+		Monster.Icon = Hints->Icon;
+		Monster.DescriptionText = AddText(Hints->Description);
+		Monster.WeaknessesText = AddText(Hints->Weaknesses);
+		Monster.StrengthsText = AddText(Hints->Strengths);
+
+		MonsterLookup.Add(Row.Key, Monsters.Num() - 1);
+		if (!Monster.Name.IsNone())
+			MonsterLookup.Add(Monster.Name, Monsters.Num() - 1);
+	}
+}
+
+void UGameDataSubsystem::FlattenQuests()
+{
+	if (!QuestsData)
+		return;
+
+	Quests.Reserve(QuestsData->GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : QuestsData->GetRowMap())
+	{
+		const FQuestInfo* Info = reinterpret_cast<const FQuestInfo*>(Row.Value);
+
+		FQuestData& Quest = Quests.AddDefaulted_GetRef();
+		Quest.Row = Row.Key;
+		Quest.Name = FName(*Info->Name);
+		Quest.Icon = Info->Icon;
+		Quest.DescriptionText = AddText(Info->Description);
+		Quest.FirstObjective = QuestObjectives.Num();
+		Quest.NumObjectives = Info->Objectives.Num();
+		QuestObjectives.Append(Info->Objectives);
+
+		QuestLookup.Add(Row.Key, Quests.Num() - 1);
+		if (!Quest.Name.IsNone())
+			QuestLookup.Add(Quest.Name, Quests.Num() - 1);
+	}
+}
+
+void UGameDataSubsystem::FlattenLevels()
+{
+	if (!LevelsData)
+		return;
+
+	Levels.Reserve(LevelsData->GetRowMap().Num());
+	for (const TPair<FName, uint8*>& Row : LevelsData->GetRowMap())
+	{
+		FLevelInfo* Info = reinterpret_cast<FLevelInfo*>(Row.Value);
+
+		FLevelData& Level = Levels.AddDefaulted_GetRef();
+		Level.Row = Row.Key;
+		Level.Name = FName(*Info->Name);
+		Level.LevelToLoad = Info->LevelToLoad;
+		Level.Icon = Info->Icon;
+
+		LevelRows.Add(Info);
+		LevelLookup.Add(Row.Key, Levels.Num() - 1);
+	}
+}
+
+int32 UGameDataSubsystem::AddText(const FString& Text)
+{
+	return Text.IsEmpty() ? INDEX_NONE : Texts.Add(&Text);
+}
+
+int32 UGameDataSubsystem::FindId(const TMap<FName, int32>& Lookup, FName Name)
+{
+	const int32* Id = Lookup.Find(Name);
+	return Id ? *Id : INDEX_NONE;
+}
+
+const FString& UGameDataSubsystem::GetText(int32 TextId) const
+{
+	static const FString Empty;
+	return Texts.IsValidIndex(TextId) ? *Texts[TextId] : Empty;
+}
+
+TArrayView<const FQuestObjective> UGameDataSubsystem::GetQuestObjectives(int32 Id) const
+{
+	if (!Quests.IsValidIndex(Id))
+		return TArrayView<const FQuestObjective>();
+
+	return TArrayView<const FQuestObjective>(QuestObjectives.GetData() + Quests[Id].FirstObjective, Quests[Id].NumObjectives);
+}
+
+void UGameDataSubsystem::MakeQuestInfo(int32 Id, FQuestInfo& OutQuest) const
+{
+	const FQuestData* Quest = GetQuest(Id);
+	if (!Quest)
+	{
+		OutQuest = FQuestInfo();
+		return;
+	}
+
+	OutQuest.Name = Quest->Name.IsNone() ? FString() : Quest->Name.ToString();
+	OutQuest.Description = GetText(Quest->DescriptionText);
+	OutQuest.Icon = Quest->Icon;
+	OutQuest.Objectives = TArray<FQuestObjective>(QuestObjectives.GetData() + Quest->FirstObjective, Quest->NumObjectives);
+}
+
+bool UGameDataSubsystem::IsLevelUnlocked(int32 Id) const
+{
+	return LevelRows.IsValidIndex(Id) && LevelRows[Id]->Unlocked;
+}
+
+void UGameDataSubsystem::SetLevelUnlocked(int32 Id, bool bUnlocked)
+{
+	if (LevelRows.IsValidIndex(Id))
+		LevelRows[Id]->Unlocked = bUnlocked;
+}
+
+FString UGameDataSubsystem::GetMonsterDescription(FName Monster) const
+{
+	const FMonsterData* Data = GetMonster(FindMonsterId(Monster));
+	return Data ? GetText(Data->DescriptionText) : FString();
+}
+
+FString UGameDataSubsystem::GetMonsterWeaknesses(FName Monster) const
+{
+	const FMonsterData* Data = GetMonster(FindMonsterId(Monster));
+	return Data ? GetText(Data->WeaknessesText) : FString();
+}
+
+FString UGameDataSubsystem::GetMonsterStrengths(FName Monster) const
+{
+	const FMonsterData* Data = GetMonster(FindMonsterId(Monster));
+	return Data ? GetText(Data->StrengthsText) : FString();
+}
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyStructs.h"
+#include "GameDataSubsystem.generated.h"
+
+class UDataTable;
+
+// Monster hints without their texts, texts are read from the game data's string table
+struct FMonsterData
+{
+	FName Row;
+	FName Name;
+	EFootprintsHint FootprintsHint = EFootprintsHint::UNKNOWN;
+	EFurHint FurHint = EFurHint::UNKNOWN;
+	EResidueHint ResidueHint = EResidueHint::UNKNOWN;
+	class UTexture2D* Icon = nullptr;
+
+	int32 DescriptionText = INDEX_NONE;
+	int32 WeaknessesText = INDEX_NONE;
+	int32 StrengthsText = INDEX_NONE;
+};
+
+struct FQuestData
+{
+	FName Row;
+	FName Name;
+	class UTexture2D* Icon = nullptr;
+	int32 DescriptionText = INDEX_NONE;
+
+	int32 FirstObjective = 0; // Objectives of every quest are contiguous
+	int32 NumObjectives = 0;
+};
+
+struct FLevelData
+{
+	FName Row;
+	FName Name;
+	FName LevelToLoad;
+	class UTexture2D* Icon = nullptr;
+};
+
+/**
+ * Gameplay data tables flattened into contiguous arrays when the game starts.
+ * Items, monsters, quests and levels get integer IDs, their position in the table, and are found by name through a single lookup.
+ * Long texts are kept out of the records, they're read from the data table row only when asked for.
+ * Every table can be set on the game instance, the default table is loaded otherwise.
+ */
+UCLASS()
+class PROJECTM_API UGameDataSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Items, by item name
+	int32 FindItemId(FName Item) const { return FindId(ItemLookup, Item); }
+	const FItemStruct* GetItem(int32 Id) const { return Items.IsValidIndex(Id) ? &Items[Id] : nullptr; }
+	int32 GetNumItems() const { return Items.Num(); }
+
+	// Monsters, by row or monster name
+	int32 FindMonsterId(FName Monster) const { return FindId(MonsterLookup, Monster); }
+	const FMonsterData* GetMonster(int32 Id) const { return Monsters.IsValidIndex(Id) ? &Monsters[Id] : nullptr; }
+	const TArray<FMonsterData>& GetMonsters() const { return Monsters; }
+
+	// Quests, by row or quest name
+	int32 FindQuestId(FName Quest) const { return FindId(QuestLookup, Quest); }
+	const FQuestData* GetQuest(int32 Id) const { return Quests.IsValidIndex(Id) ? &Quests[Id] : nullptr; }
+	const TArray<FQuestData>& GetQuests() const { return Quests; }
+	TArrayView<const FQuestObjective> GetQuestObjectives(int32 Id) const;
+	void MakeQuestInfo(int32 Id, FQuestInfo& OutQuest) const; // Copy for the game instance's current quest
+
+	// Levels, by row
+	int32 FindLevelId(FName Level) const { return FindId(LevelLookup, Level); }
+	const FLevelData* GetLevel(int32 Id) const { return Levels.IsValidIndex(Id) ? &Levels[Id] : nullptr; }
+	int32 GetNumLevels() const { return Levels.Num(); }
+	bool IsLevelUnlocked(int32 Id) const;
+	void SetLevelUnlocked(int32 Id, bool bUnlocked); // Also updates the levels data table, the level widgets read it
+
+	const FString& GetText(int32 TextId) const; // Empty if none
+
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+		FString GetMonsterDescription(FName Monster) const;
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+		FString GetMonsterWeaknesses(FName Monster) const;
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+		FString GetMonsterStrengths(FName Monster) const;
+
+private:
+	// Keep the tables loaded, records point to their assets and texts
+	UPROPERTY()
+		UDataTable* ItemsData;
+	UPROPERTY()
+		UDataTable* MonsterHintsData;
+	UPROPERTY()
+		UDataTable* QuestsData;
+	UPROPERTY()
+		UDataTable* LevelsData;
+
+	TArray<FItemStruct> Items;
+	TArray<FMonsterData> Monsters;
+	TArray<FQuestData> Quests;
+	TArray<FQuestObjective> QuestObjectives;
+	TArray<FLevelData> Levels;
+	TArray<FLevelInfo*> LevelRows; // Same indexing as Levels, unlocks stay in the rows for the level widgets
+
+	TMap<FName, int32> ItemLookup;
+	TMap<FName, int32> MonsterLookup;
+	TMap<FName, int32> QuestLookup;
+	TMap<FName, int32> LevelLookup;
+
+	TArray<const FString*> Texts; // String table, long texts stay in their data table row
+
+	void FlattenItems();
+	void FlattenMonsters();
+	void FlattenQuests();
+	void FlattenLevels();
+
+	int32 AddText(const FString& Text); // INDEX_NONE if empty
+	static int32 FindId(const TMap<FName, int32>& Lookup, FName Name);
+	static UDataTable* LoadTable(UDataTable* Table, const TCHAR* DefaultPath);
+};
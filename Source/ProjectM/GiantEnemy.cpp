@@ -5,12 +5,14 @@
 #include "Enemy.h"
 #include "Projectile.h"
 #include "Components/SceneComponent.h"
-#include "NiagaraFunctionLibrary.h"
+#include "VfxSubsystem.h"
 #include "Components/BoxComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "SoundManager.h"
 #include "HealthComponent.h"
+#include "ActorPoolSubsystem.h"
+#include "Components/CapsuleComponent.h"
 
 AGiantEnemy::AGiantEnemy()
 {
@@ -25,6 +27,68 @@ void AGiantEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Spawn projectiles, telegraphs and minions up front so attacks only have to place them
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	Pool->Prewarm(ProjectileClass, ProjectilePoolSize, SpawnPoint->GetComponentTransform());
+	Pool->Prewarm(VisualsClass, ProjectilePoolSize, GetActorTransform());
+
+	// Vomit plays for both projectiles and minions
+	UVfxSubsystem* Vfx = GetWorld()->GetSubsystem<UVfxSubsystem>();
+	Vfx->Prewarm(StompVfx, 2);
+	Vfx->Prewarm(VomitVfx, 2);
+
+	if (MinionClass == nullptr)
+		return;
+
+	BuildMinionSpawnSlots();
+
+	Pool->Prewarm(MinionClass, GetMinionPoolSize(), SpawnPoint->GetComponentTransform());
+}
+
+// Place a slot for each pooled minion on a ring around the spawn point
+void AGiantEnemy::BuildMinionSpawnSlots()
+{
+	const int32 NumSlots = FMath::Max(GetMinionPoolSize(), 1);
+
+	// Neighbouring slots are a chord apart, it must fit two minion capsules
+	const ACharacter* MinionDefaults = MinionClass->GetDefaultObject<ACharacter>();
+	const float MinionRadius = MinionDefaults->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	const float Radius = NumSlots > 1 ? FMath::Max(MinionSpawnRadius, MinionRadius / FMath::Sin(PI / NumSlots)) : MinionSpawnRadius;
+
+	MinionSpawnSlots.Reset(NumSlots);
+	for (int i = 0; i < NumSlots; i++)
+	{
+		const float Angle = 2.0f * PI * i / NumSlots;
+		MinionSpawnSlots.Add(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Radius);
+	}
+
+	MinionSpawnSlotOccupants.Reset();
+	MinionSpawnSlotOccupants.SetNum(NumSlots);
+}
+
+int32 AGiantEnemy::AcquireMinionSpawnSlot()
+{
+	for (int32 i = 0; i < MinionSpawnSlots.Num(); i++)
+	{
+		const int32 Slot = (NextMinionSpawnSlot + i) % MinionSpawnSlots.Num();
+		if (MinionSpawnSlotOccupants[Slot].IsValid())
+			continue;
+
+		NextMinionSpawnSlot = (Slot + 1) % MinionSpawnSlots.Num();
+		return Slot;
+	}
+
+	return INDEX_NONE;
+}
+
+// Free the minion's slot once its corpse is back in the pool
+void AGiantEnemy::OnMinionReleased(AEnemy* Minion)
+{
+	Minion->OnReleasedToPool.RemoveAll(this);
+
+	const int32 Slot = MinionSpawnSlotOccupants.IndexOfByKey(Minion);
+	if (Slot != INDEX_NONE)
+		MinionSpawnSlotOccupants[Slot] = nullptr;
 }
 
 void AGiantEnemy::MeleeAttackAction()
@@ -39,10 +103,10 @@ void AGiantEnemy::BeginMeleeAttack()
 
 	if (StompVfx != nullptr)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), StompVfx, GetMesh()->GetSocketLocation(TEXT("ball_r")), GetActorRotation());
+		GetWorld()->GetSubsystem<UVfxSubsystem>()->SpawnSystemAtLocation(StompVfx, GetMesh()->GetSocketLocation(TEXT("ball_r")), GetActorRotation());
 	}
 
-	SoundManager::PlayRandomSoundAtLocation(GetWorld(), StompSfx, GetMesh()->GetSocketLocation(TEXT("ball_r")), SoundAttenuation);
+	GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(StompSfx, GetMesh()->GetSocketLocation(TEXT("ball_r")), SoundAttenuation);
 }
 
 void AGiantEnemy::EndMeleeAttack()
@@ -73,9 +137,21 @@ void AGiantEnemy::SpawnMinions()
 
 	int Amount = FMath::RandRange((int)MinMinionsSpawn, (int)MaxMinionsSpawn);
 
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
 	for (int i = 0; i < Amount; i++)
 	{
-		GetWorld()->SpawnActor<ACharacter>(MinionClass, SpawnPoint->GetComponentLocation(), GetActorRotation(), FActorSpawnParameters());
+		// Each minion takes a slot no other minion is standing on, the rest of the spawn is skipped if there are none
+		const int32 Slot = AcquireMinionSpawnSlot();
+		if (Slot == INDEX_NONE)
+			break;
+
+		const FVector SlotLocation = SpawnPoint->GetComponentLocation() + GetActorRotation().RotateVector(MinionSpawnSlots[Slot]);
+		AEnemy* Minion = Pool->Acquire<AEnemy>(MinionClass, FTransform(GetActorRotation(), SlotLocation));
+		if (Minion == nullptr)
+			continue;
+
+		MinionSpawnSlotOccupants[Slot] = Minion;
+		Minion->OnReleasedToPool.AddUObject(this, &AGiantEnemy::OnMinionReleased);
 	}
 
 	PlayVomitVFX();
@@ -92,12 +168,15 @@ void AGiantEnemy::ProjectileAttackAction()
 	GetMesh()->GetAnimInstance()->Montage_Play(ProjectileMontage);
 	ProjectileTarget = UGameplayStatics::GetPlayerPawn(GetWorld(), 0)->GetActorLocation() + FVector::DownVector * 90.0f;
 
+	// Return the telegraph of a projectile that was never launched
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
 	if (CurrentVisuals != nullptr)
-		CurrentVisuals->Destroy();
+		Pool->Release(CurrentVisuals);
+	CurrentVisuals = nullptr;
 
 	if (VisualsClass != nullptr)
 	{
-		CurrentVisuals = GetWorld()->SpawnActor<AActor>(VisualsClass, ProjectileTarget, GetActorRotation(), FActorSpawnParameters());
+		CurrentVisuals = Pool->Acquire(VisualsClass, FTransform(GetActorRotation(), ProjectileTarget));
 	}
 
 }
@@ -110,7 +189,8 @@ void AGiantEnemy::ProjectileAttack()
 		return;
 	}
 
-	AProjectile* Projectile = GetWorld()->SpawnActor<AProjectile>(ProjectileClass, SpawnPoint->GetComponentLocation(), GetActorRotation(), FActorSpawnParameters());
+	AProjectile* Projectile = GetWorld()->GetSubsystem<UActorPoolSubsystem>()->Acquire<AProjectile>(ProjectileClass,
+		FTransform(GetActorRotation(), SpawnPoint->GetComponentLocation()));
 
 	if (!Projectile)
 	{
@@ -118,7 +198,9 @@ void AGiantEnemy::ProjectileAttack()
 		return;
 	}
 
+	// The projectile returns the telegraph to the pool when it explodes
 	Projectile->Launch(ProjectileTarget, CurrentVisuals, this);
+	CurrentVisuals = nullptr;
 
 	PlayVomitVFX();
 }
@@ -127,13 +209,13 @@ void AGiantEnemy::PlayVomitVFX()
 {
 	if (VomitVfx != nullptr)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), VomitVfx, SpawnPoint->GetComponentLocation(), GetActorRotation());
+		GetWorld()->GetSubsystem<UVfxSubsystem>()->SpawnSystemAtLocation(VomitVfx, SpawnPoint->GetComponentLocation(), GetActorRotation());
 	}
 }
 
 void AGiantEnemy::PlayVomitSFX()
 {
-	SoundManager::PlayRandomSoundAtLocation(GetWorld(), VomitSfx, SpawnPoint->GetComponentLocation(), SoundAttenuation);
+	GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(VomitSfx, SpawnPoint->GetComponentLocation(), SoundAttenuation);
 }
 
 void AGiantEnemy::TakeDamage(float Amount)
@@ -62,6 +62,20 @@ private:
 	UPROPERTY(EditAnywhere, Category="Minions")
 		uint32 MaxMinionsSpawn;
 
+	UPROPERTY(EditAnywhere, Category = "Minions")
+		int32 MinionPoolSize = 0; // Minions spawned hidden at begin play and reused, 0 prewarms twice the max minions spawned at once
+	int32 GetMinionPoolSize() const { return MinionPoolSize > 0 ? MinionPoolSize : (int32)MaxMinionsSpawn * 2; }
+
+	UPROPERTY(EditAnywhere, Category = "Minions")
+		float MinionSpawnRadius = 150.0f; // Min radius of the ring of spawn slots around the spawn point
+
+	TArray<FVector> MinionSpawnSlots; // Offsets from the spawn point in actor space, far enough apart for minions not to overlap
+	TArray<TWeakObjectPtr<AEnemy>> MinionSpawnSlotOccupants; // Minion standing on each slot, until it's released to the pool
+	int32 NextMinionSpawnSlot = 0; // Where the search for a free slot starts
+	void BuildMinionSpawnSlots();
+	int32 AcquireMinionSpawnSlot(); // Next free slot, INDEX_NONE if every slot is occupied
+	void OnMinionReleased(AEnemy* Minion);
+
 	UPROPERTY(EditAnywhere, Category = "Minions")
 		class UNiagaraSystem* VomitVfx;
 
@@ -77,6 +91,9 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Projectile")
 		TSubclassOf<AActor> VisualsClass;
 
+	UPROPERTY(EditAnywhere, Category = "Projectile")
+		int32 ProjectilePoolSize = 4; // Projectiles and telegraph visuals spawned hidden at begin play and reused
+
 	UPROPERTY(EditAnywhere)
 		TArray<USoundBase*> VomitSfx;
 
@@ -84,7 +101,7 @@ private:
 		TArray<USoundBase*> StompSfx;
 
 	FVector ProjectileTarget;
-	AActor* CurrentVisuals;
+	AActor* CurrentVisuals = nullptr; // Telegraph of the next projectile, owned by the projectile once launched
 
 	void PlayVomitVFX();
 };
@@ -39,6 +39,12 @@ void UHealthComponent::Heal(float Amount)
 	CurrentHP = FMath::Clamp(CurrentHP, 0.0f, MaxHP);
 }
 
+// Set CurrentHP back to MaxHP
+void UHealthComponent::ResetHealth()
+{
+	CurrentHP = MaxHP;
+}
+
 bool UHealthComponent::IsDead()
 {
 	return CurrentHP <= 0.0f;
@@ -25,6 +25,8 @@ public:
 		void TakeDamage(float Amount); // Decrease CurrentHP by given amount
 	UFUNCTION(BlueprintCallable)
 		void Heal(float Amount); // Increase CurrentHP by given amount
+	UFUNCTION(BlueprintCallable)
+		void ResetHealth(); // Set CurrentHP back to MaxHP
 
 	UFUNCTION(BlueprintCallable)
 		bool IsDead(); // Returns true if CurrentHP < 0
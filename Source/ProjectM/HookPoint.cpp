@@ -2,6 +2,7 @@
 
 
 #include "HookPoint.h"
+#include "HookPointSubsystem.h"
 
 // Sets default values
 AHookPoint::AHookPoint()
@@ -15,7 +16,35 @@ AHookPoint::AHookPoint()
 void AHookPoint::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Register in the world's hook point registry so the player can find it
+	UHookPointSubsystem* HookPointSubsystem = GetWorld()->GetSubsystem<UHookPointSubsystem>();
+	if (HookPointSubsystem)
+		HookPointSubsystem->RegisterHookPoint(this);
+
+	// Hook points attached to enemies or physics objects need to update their registry location when they move
+	if (GetRootComponent() && GetRootComponent()->Mobility != EComponentMobility::Static)
+		TransformUpdatedHandle = GetRootComponent()->TransformUpdated.AddUObject(this, &AHookPoint::OnRootTransformUpdated);
+}
+
+// Called when destroyed or when its level is streamed out
+void AHookPoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetRootComponent() && TransformUpdatedHandle.IsValid())
+		GetRootComponent()->TransformUpdated.Remove(TransformUpdatedHandle);
+
+	UHookPointSubsystem* HookPointSubsystem = GetWorld()->GetSubsystem<UHookPointSubsystem>();
+	if (HookPointSubsystem)
+		HookPointSubsystem->UnregisterHookPoint(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AHookPoint::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	UHookPointSubsystem* HookPointSubsystem = GetWorld()->GetSubsystem<UHookPointSubsystem>();
+	if (HookPointSubsystem)
+		HookPointSubsystem->UpdateHookPoint(this);
 }
 
 // Called every frame
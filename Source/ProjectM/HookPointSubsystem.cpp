@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HookPointSubsystem.h"
+#include "HookPoint.h"
+
+void UHookPointSubsystem::Deinitialize()
+{
+	HookPoints.Reset();
+	Locations.Reset();
+	FreeSlots.Reset();
+	SlotLookup.Reset();
+	Grid.Reset();
+
+	Super::Deinitialize();
+}
+
+// Add hook point to the registry and bucket it by its current location
+void UHookPointSubsystem::RegisterHookPoint(AHookPoint* HookPoint)
+{
+	if (!HookPoint || SlotLookup.Contains(HookPoint))
+		return;
+
+	// Reuse a free slot if there is one
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+		HookPoints[Slot] = HookPoint;
+		Locations[Slot] = HookPoint->GetActorLocation();
+	}
+	else
+	{
+		Slot = HookPoints.Add(HookPoint);
+		Locations.Add(HookPoint->GetActorLocation());
+	}
+
+	SlotLookup.Add(HookPoint, Slot);
+	Grid.Add(Slot, Locations[Slot]);
+}
+
+// Remove hook point from the registry and free its slot
+void UHookPointSubsystem::UnregisterHookPoint(AHookPoint* HookPoint)
+{
+	int32 Slot;
+	if (!SlotLookup.RemoveAndCopyValue(HookPoint, Slot))
+		return;
+
+	Grid.Remove(Slot);
+	HookPoints[Slot] = nullptr;
+	FreeSlots.Add(Slot);
+}
+
+// Refresh cached location, only re-buckets when the hook point changes cell
+void UHookPointSubsystem::UpdateHookPoint(AHookPoint* HookPoint)
+{
+	const int32* Slot = SlotLookup.Find(HookPoint);
+	if (!Slot)
+		return;
+
+	Locations[*Slot] = HookPoint->GetActorLocation();
+	Grid.Move(*Slot, Locations[*Slot]);
+}
+
+void UHookPointSubsystem::QueryHookPoints(const FVector& Center, float Radius, FTargetCandidates& OutCandidates) const
+{
+	QueryScratch.Reset();
+	Grid.Query(Center, Radius, QueryScratch);
+
+	const float RadiusSquared = Radius * Radius;
+	for (int32 Slot : QueryScratch)
+	{
+		if (HookPoints[Slot] == nullptr)
+			continue;
+
+		if (FVector::DistSquared(Locations[Slot], Center) <= RadiusSquared)
+			OutCandidates.Add(HookPoints[Slot], Locations[Slot]);
+	}
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "TargetScoring.h"
+#include "HookPointSubsystem.generated.h"
+
+class AHookPoint;
+
+/**
+ * Registry of every hook point in the world, bucketed in a uniform grid
+ * so the player can range query them instead of sphere tracing every frame.
+ */
+UCLASS()
+class PROJECTM_API UHookPointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterHookPoint(AHookPoint* HookPoint); // Called from the hook point's BeginPlay
+	void UnregisterHookPoint(AHookPoint* HookPoint); // Called from the hook point's EndPlay (also on sublevel unload)
+	void UpdateHookPoint(AHookPoint* HookPoint); // Refresh the location of a moving hook point
+
+	// Appends every registered hook point within radius of center, with its cached location, ready for FTargetScoring
+	void QueryHookPoints(const FVector& Center, float Radius, FTargetCandidates& OutCandidates) const;
+
+	int32 GetNumHookPoints() const { return SlotLookup.Num(); }
+
+private:
+	static constexpr float CellSize = 1000.0f; // Grid cell size, roughly half the player's detection distance
+
+	UPROPERTY()
+		TArray<AHookPoint*> HookPoints; // Registered hook points, null on free slots
+	TArray<FVector> Locations; // Cached hook point locations, same indexing as HookPoints
+	TArray<int32> FreeSlots; // Slots freed by unregistered hook points to be reused
+
+	TMap<AHookPoint*, int32> SlotLookup; // Hook point to slot index
+
+	FSpatialHashGrid Grid = FSpatialHashGrid(CellSize);
+
+	mutable TArray<int32> QueryScratch; // Reused buffer for grid queries
+};
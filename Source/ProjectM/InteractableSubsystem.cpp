@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractableSubsystem.h"
+#include "InteractionInterface.h"
+#include "EngineUtils.h"
+
+void UInteractableSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Actors spawned during play and levels streamed in register themselves here
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UInteractableSubsystem::OnActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UInteractableSubsystem::OnLevelAdded);
+}
+
+void UInteractableSubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	Interactables.Reset();
+	Owners.Reset();
+	Interfaces.Reset();
+	Bounds.Reset();
+	MaxBoundsRadius = 0.0f;
+	FreeSlots.Reset();
+	SlotLookup.Reset();
+	TransformUpdatedHandles.Reset();
+	Grid.Reset();
+
+	Super::Deinitialize();
+}
+
+// Register the actors already in the world
+void UInteractableSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+		RegisterActor(*It);
+}
+
+void UInteractableSubsystem::OnActorSpawned(AActor* Actor)
+{
+	RegisterActor(Actor);
+}
+
+void UInteractableSubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || Level == nullptr)
+		return;
+
+	for (AActor* Actor : Level->Actors)
+		RegisterActor(Actor);
+}
+
+// Resolve the interactable once, the actor itself or its first interactable component
+void UInteractableSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || SlotLookup.Contains(Actor))
+		return;
+
+	UObject* Interactable = nullptr;
+	if (Actor->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
+	{
+		Interactable = Actor;
+	}
+	else
+	{
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component && Component->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
+			{
+				Interactable = Component;
+				break;
+			}
+		}
+	}
+
+	if (Interactable == nullptr)
+		return;
+
+	// Reuse a free slot if there is one
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+		Interactables[Slot] = Interactable;
+		Owners[Slot] = Actor;
+		Interfaces[Slot] = Cast<IInteractionInterface>(Interactable);
+		Bounds[Slot] = ComputeBounds(Actor);
+	}
+	else
+	{
+		Slot = Interactables.Add(Interactable);
+		Owners.Add(Actor);
+		Interfaces.Add(Cast<IInteractionInterface>(Interactable));
+		Bounds.Add(ComputeBounds(Actor));
+	}
+
+	SlotLookup.Add(Actor, Slot);
+	Grid.Add(Slot, Bounds[Slot].GetCenter());
+
+	Actor->OnEndPlay.AddDynamic(this, &UInteractableSubsystem::OnActorEndPlay);
+
+	// Characters and other movable interactables need to update their registry location when they move
+	if (Actor->GetRootComponent() && Actor->GetRootComponent()->Mobility != EComponentMobility::Static)
+		TransformUpdatedHandles.Add(Actor, Actor->GetRootComponent()->TransformUpdated.AddUObject(this, &UInteractableSubsystem::OnRootTransformUpdated));
+}
+
+// Remove interactable from the registry and free its slot
+void UInteractableSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Slot;
+	if (!SlotLookup.RemoveAndCopyValue(Actor, Slot))
+		return;
+
+	FDelegateHandle TransformUpdatedHandle;
+	if (TransformUpdatedHandles.RemoveAndCopyValue(Actor, TransformUpdatedHandle) && Actor->GetRootComponent())
+		Actor->GetRootComponent()->TransformUpdated.Remove(TransformUpdatedHandle);
+
+	Actor->OnEndPlay.RemoveDynamic(this, &UInteractableSubsystem::OnActorEndPlay);
+
+	Grid.Remove(Slot);
+	Interactables[Slot] = nullptr;
+	Owners[Slot] = nullptr;
+	Interfaces[Slot] = nullptr;
+	FreeSlots.Add(Slot);
+}
+
+void UInteractableSubsystem::OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterActor(Actor);
+}
+
+FBox UInteractableSubsystem::ComputeBounds(const AActor* Actor)
+{
+	FBox ActorBounds = Actor->GetComponentsBoundingBox(false);
+	if (!ActorBounds.IsValid)
+		ActorBounds = FBox(Actor->GetActorLocation(), Actor->GetActorLocation());
+
+	MaxBoundsRadius = FMath::Max(MaxBoundsRadius, ActorBounds.GetExtent().Size());
+	return ActorBounds;
+}
+
+// Refresh cached bounds, only re-buckets when the interactable changes cell
+void UInteractableSubsystem::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	const int32* Slot = SlotLookup.Find(UpdatedComponent->GetOwner());
+	if (!Slot)
+		return;
+
+	Bounds[*Slot] = ComputeBounds(UpdatedComponent->GetOwner());
+	Grid.Move(*Slot, Bounds[*Slot].GetCenter());
+}
+
+// Bounds are tested in the box's space, against the box of their corners there, so rotated boxes can only overlap more
+UObject* UInteractableSubsystem::FindClosestInteractable(const FTransform& BoxTransform, const FVector& BoxExtent, const AActor* IgnoredActor, IInteractionInterface*& OutInterface) const
+{
+	const FVector Center = BoxTransform.GetLocation();
+	const FVector ScaledExtent = BoxExtent * BoxTransform.GetScale3D().GetAbs();
+	const FTransform WorldToBox = BoxTransform.Inverse();
+	const FBox LocalBox(-BoxExtent, BoxExtent);
+
+	QueryScratch.Reset();
+	Grid.Query(Center, ScaledExtent.Size() + MaxBoundsRadius, QueryScratch);
+
+	int32 ClosestSlot = INDEX_NONE;
+	float ClosestDistanceSquared = BIG_NUMBER;
+	for (int32 Slot : QueryScratch)
+	{
+		if (Interactables[Slot] == nullptr || Owners[Slot] == IgnoredActor)
+			continue;
+
+		if (!LocalBox.Intersect(Bounds[Slot].TransformBy(WorldToBox)))
+			continue;
+
+		const float DistanceSquared = Bounds[Slot].ComputeSquaredDistanceToPoint(Center);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestSlot = Slot;
+		}
+	}
+
+	if (ClosestSlot == INDEX_NONE)
+	{
+		OutInterface = nullptr;
+		return nullptr;
+	}
+
+	OutInterface = Interfaces[ClosestSlot];
+	return Interactables[ClosestSlot];
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "InteractableSubsystem.generated.h"
+
+class IInteractionInterface;
+
+/**
+ * Registry of every interactable in the world, bucketed in a uniform grid.
+ * Actors implementing the interaction interface, or owning a component that does, are registered once
+ * when they are spawned or their level is loaded, with the resolved interactable and the world bounds of its actor's
+ * colliding components, so the player picks the closest one overlapping its interaction box with a single grid query.
+ */
+UCLASS()
+class PROJECTM_API UInteractableSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	void RegisterActor(AActor* Actor); // Registers the actor if it or one of its components is interactable
+	void UnregisterActor(AActor* Actor);
+
+	// Closest interactable whose bounds overlap the box, given by its transform and unscaled extent
+	// The interface is null when only implemented in blueprints
+	UObject* FindClosestInteractable(const FTransform& BoxTransform, const FVector& BoxExtent, const AActor* IgnoredActor, IInteractionInterface*& OutInterface) const;
+
+	int32 GetNumInteractables() const { return SlotLookup.Num(); }
+
+private:
+	static constexpr float CellSize = 500.0f; // Grid cell size, a few times the player's interaction range
+
+	UPROPERTY()
+		TArray<UObject*> Interactables; // Interactable actor or component, null on free slots
+	UPROPERTY()
+		TArray<AActor*> Owners; // Actor of each interactable, same indexing as Interactables
+	TArray<IInteractionInterface*> Interfaces; // Resolved native interfaces, same indexing as Interactables
+	TArray<FBox> Bounds; // Cached world bounds of the owners' colliding components, same indexing as Interactables
+	float MaxBoundsRadius = 0.0f; // Largest bounds registered, widens grid queries so large interactables are found from their edges
+	TArray<int32> FreeSlots; // Slots freed by unregistered interactables to be reused
+
+	TMap<const AActor*, int32> SlotLookup; // Owner actor to slot index
+	TMap<const AActor*, FDelegateHandle> TransformUpdatedHandles; // Movable interactables keep their bounds up to date
+
+	FSpatialHashGrid Grid = FSpatialHashGrid(CellSize); // Bucketed by bounds center
+
+	FBox ComputeBounds(const AActor* Actor); // Colliding components, like the overlaps the trigger used to get, or the actor location if none
+
+	mutable TArray<int32> QueryScratch; // Reused buffer for grid queries
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World); // Register the actors of a streamed in level
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	UFUNCTION()
+		void OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+};
@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InventorySubsystem.h"
+#include "QuestSubsystem.h"
+#include "VenariGameInstance.h"
+#include "GameDataSubsystem.h"
+
+// Fill the slots with the starting inventory
+void UInventorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency(UGameDataSubsystem::StaticClass());
+	GameData = GetGameInstance()->GetSubsystem<UGameDataSubsystem>();
+	GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+
+	ResetFromGameInstance();
+}
+
+void UInventorySubsystem::ResetFromGameInstance()
+{
+	Slots.Reset();
+	FreeSlots.Reset();
+	SlotLookup.Reset();
+
+	if (!GameInstance)
+		return;
+
+	for (int32 Slot = 0; Slot < GameInstance->InventoryData.Num(); Slot++)
+	{
+		const FItemStruct& Item = GameInstance->InventoryData[Slot];
+		const int32 Id = Item.Name.IsNone() ? INDEX_NONE : GameData->FindItemId(Item.Name);
+
+		FItemStack& Stack = Slots.AddDefaulted_GetRef();
+		if (Id != INDEX_NONE)
+		{
+			Stack.Item = Id;
+			Stack.Quantity = Item.Quantity;
+			SlotLookup.Add(Item.Name, Slot);
+		}
+	}
+
+	// Free slots are popped from the back, first slots are reused first
+	for (int32 Slot = Slots.Num() - 1; Slot >= 0; Slot--)
+	{
+		if (Slots[Slot].IsEmpty())
+			FreeSlots.Add(Slot);
+	}
+}
+
+void UInventorySubsystem::Deinitialize()
+{
+	Slots.Reset();
+	FreeSlots.Reset();
+	SlotLookup.Reset();
+	GameData = nullptr;
+	GameInstance = nullptr;
+
+	Super::Deinitialize();
+}
+
+// Blueprints written before the subsystem edit the inventory data directly, compare it slot by slot before changing the slots
+void UInventorySubsystem::SyncFromGameInstance()
+{
+	if (!GameInstance)
+		return;
+
+	const TArray<FItemStruct>& InventoryData = GameInstance->InventoryData;
+	bool bChanged = InventoryData.Num() != Slots.Num();
+	for (int32 Slot = 0; Slot < Slots.Num() && !bChanged; Slot++)
+	{
+		const FItemStruct* Item = GetSlotItem(Slot);
+		if (Item)
+			bChanged = InventoryData[Slot].Name != Item->Name || InventoryData[Slot].Quantity != Slots[Slot].Quantity;
+		else
+			bChanged = !InventoryData[Slot].Name.IsNone();
+	}
+
+	if (bChanged)
+		ResetFromGameInstance();
+}
+
+bool UInventorySubsystem::AddItem(FName ItemName, int32 Quantity)
+{
+	if (Quantity <= 0)
+		return false;
+
+	SyncFromGameInstance();
+
+	const int32 Id = GameData->FindItemId(ItemName);
+	if (Id == INDEX_NONE)
+		return false;
+
+	// Stackable items merge with their only stack
+	if (GameData->GetItem(Id)->bStackable)
+	{
+		if (const int32* Slot = SlotLookup.Find(ItemName))
+		{
+			SetSlot(*Slot, Id, Slots[*Slot].Quantity + Quantity);
+		}
+		else
+		{
+			const int32 Slot = AcquireSlot();
+			SlotLookup.Add(ItemName, Slot);
+			SetSlot(Slot, Id, Quantity);
+		}
+	}
+	else
+	{
+		// Every unit of a non stackable item takes its own slot
+		for (int32 i = 0; i < Quantity; i++)
+		{
+			const int32 Slot = AcquireSlot();
+			SlotLookup.Add(ItemName, Slot);
+			SetSlot(Slot, Id, 1);
+		}
+	}
+
+	GetGameInstance()->GetSubsystem<UQuestSubsystem>()->RecordEvent(EQuestEventType::COLLECT, ItemName, Quantity);
+	return true;
+}
+
+bool UInventorySubsystem::RemoveItem(FName ItemName, int32 Quantity)
+{
+	if (Quantity <= 0)
+		return false;
+
+	SyncFromGameInstance();
+	if (GetItemQuantity(ItemName) < Quantity)
+		return false;
+
+	while (Quantity > 0)
+	{
+		const int32 Slot = *SlotLookup.Find(ItemName);
+		const FItemStack Stack = Slots[Slot];
+
+		const int32 Removed = FMath::Min(Stack.Quantity, Quantity);
+		Quantity -= Removed;
+
+		if (Stack.Quantity > Removed)
+		{
+			SetSlot(Slot, Stack.Item, Stack.Quantity - Removed);
+			continue;
+		}
+
+		// Empty the slot so it can be reused
+		SlotLookup.RemoveSingle(ItemName, Slot);
+		SetSlot(Slot, INDEX_NONE, 0);
+		FreeSlots.Add(Slot);
+	}
+
+	return true;
+}
+
+bool UInventorySubsystem::RemoveItemAtSlot(int32 Slot, int32 Quantity)
+{
+	if (Quantity <= 0)
+		return false;
+
+	SyncFromGameInstance();
+	if (!Slots.IsValidIndex(Slot) || Slots[Slot].IsEmpty() || Slots[Slot].Quantity < Quantity)
+		return false;
+
+	const FItemStack Stack = Slots[Slot];
+	if (Stack.Quantity > Quantity)
+	{
+		SetSlot(Slot, Stack.Item, Stack.Quantity - Quantity);
+		return true;
+	}
+
+	SlotLookup.RemoveSingle(GameData->GetItem(Stack.Item)->Name, Slot);
+	SetSlot(Slot, INDEX_NONE, 0);
+	FreeSlots.Add(Slot);
+	return true;
+}
+
+int32 UInventorySubsystem::GetItemQuantity(FName ItemName) const
+{
+	int32 Quantity = 0;
+	for (auto It = SlotLookup.CreateConstKeyIterator(ItemName); It; ++It)
+		Quantity += Slots[It.Value()].Quantity;
+
+	return Quantity;
+}
+
+const FItemStruct* UInventorySubsystem::GetSlotItem(int32 Slot) const
+{
+	if (!Slots.IsValidIndex(Slot) || Slots[Slot].IsEmpty())
+		return nullptr;
+
+	return GameData->GetItem(Slots[Slot].Item);
+}
+
+const FItemStruct* UInventorySubsystem::FindItemData(FName ItemName) const
+{
+	return GameData->GetItem(GameData->FindItemId(ItemName));
+}
+
+int32 UInventorySubsystem::AcquireSlot()
+{
+	if (FreeSlots.Num() > 0)
+		return FreeSlots.Pop(false);
+
+	return Slots.AddDefaulted();
+}
+
+// Widgets read the game instance's inventory data, only the changed slot is copied
+void UInventorySubsystem::SetSlot(int32 Slot, int32 Item, int32 Quantity)
+{
+	Slots[Slot].Item = Item;
+	Slots[Slot].Quantity = Quantity;
+
+	if (!GameInstance)
+		return;
+
+	if (GameInstance->InventoryData.Num() <= Slot)
+		GameInstance->InventoryData.SetNum(Slot + 1);
+
+	FItemStruct& SlotData = GameInstance->InventoryData[Slot];
+	if (Item == INDEX_NONE)
+	{
+		SlotData = FItemStruct();
+		return;
+	}
+
+	SlotData = *GameData->GetItem(Item);
+	SlotData.Quantity = Quantity;
+}
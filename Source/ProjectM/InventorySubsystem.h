@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyStructs.h"
+#include "InventorySubsystem.generated.h"
+
+class UGameDataSubsystem;
+
+// Compact handle of an inventory slot, the item's ID in the game data and how many are held
+struct FItemStack
+{
+	int32 Item = INDEX_NONE; // Empty slot if none
+	int32 Quantity = 0;
+
+	bool IsEmpty() const { return Item == INDEX_NONE; }
+};
+
+/**
+ * Player inventory, kept across levels.
+ * Slots only hold an item ID and a quantity, static item data is read from the game data.
+ * Items are found by name through hash maps so adding, removing and merging stacks doesn't search the slots.
+ * The game instance's inventory data is the starting inventory and is kept up to date, slot by slot, for the widgets.
+ * Blueprints that still edit the inventory data directly are picked up before the next change, instead of being overwritten.
+ */
+UCLASS()
+class PROJECTM_API UInventorySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+		bool AddItem(FName ItemName, int32 Quantity); // Merge with the item's stack, or take a free slot
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+		bool RemoveItem(FName ItemName, int32 Quantity); // Fails if not enough are held, empties the slot when none are left
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+		bool RemoveItemAtSlot(int32 Slot, int32 Quantity); // Same as RemoveItem, only from the given slot
+
+	void ResetFromGameInstance(); // Refill the slots from the game instance's inventory data, after loading a save
+
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+		int32 GetItemQuantity(FName ItemName) const;
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+		int32 GetNumSlots() const { return Slots.Num(); }
+
+	const FItemStack* GetStack(int32 Slot) const { return Slots.IsValidIndex(Slot) ? &Slots[Slot] : nullptr; }
+	const FItemStruct* GetSlotItem(int32 Slot) const; // Static data of the slot's item, null if empty
+	const FItemStruct* FindItemData(FName ItemName) const; // Static data of the item, null if not in the game data
+
+private:
+	class UVenariGameInstance* GameInstance = nullptr;
+
+	UPROPERTY()
+		UGameDataSubsystem* GameData;
+
+	TArray<FItemStack> Slots;
+	TArray<int32> FreeSlots; // Empty slots to be reused
+	TMultiMap<FName, int32> SlotLookup; // Item name to the slots holding it, one for stackable items
+
+	void SyncFromGameInstance(); // Refill the slots if blueprints changed the game instance's inventory data
+	int32 AcquireSlot(); // Free slot, or a new one
+	void SetSlot(int32 Slot, int32 Item, int32 Quantity); // Update the slot and its widget copy
+};
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MeleeTraceComponent.h"
+#include "ProjectM.h"
+#include "Components/BoxComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee trace"), STAT_VenariMeleeTrace, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee sweeps"), STAT_VenariMeleeSweeps, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee hits"), STAT_VenariMeleeHits, STATGROUP_Venari);
+
+// Sets default values for this component's properties
+UMeleeTraceComponent::UMeleeTraceComponent()
+{
+	// Only tick while swinging, after animation has moved the weapon
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UMeleeTraceComponent::SetTraceBox(UBoxComponent* Box)
+{
+	TraceBox = Box;
+}
+
+// Test the box where it is and start sweeping it every frame
+void UMeleeTraceComponent::BeginSwing()
+{
+	if (TraceBox == nullptr)
+		return;
+
+	SwingHits.Reset();
+	NewHits.Reset();
+	LastTransform = TraceBox->GetComponentTransform();
+	bSwinging = true;
+
+	// Actors already inside the box are hit at the start of the swing
+	Sweep(LastTransform, LastTransform);
+	DeliverHits();
+
+	// Hit delegate might have ended the swing
+	if (bSwinging)
+		SetComponentTickEnabled(true);
+}
+
+void UMeleeTraceComponent::EndSwing()
+{
+	bSwinging = false;
+	SetComponentTickEnabled(false);
+}
+
+// Sweep the box from last frame's transform to the current one
+void UMeleeTraceComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bSwinging || TraceBox == nullptr)
+	{
+		EndSwing();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VenariMeleeTrace);
+
+	const FTransform CurrentTransform = TraceBox->GetComponentTransform();
+
+	// A box can't rotate during a sweep, split fast swings so the rotation between sweeps stays small
+	const float Angle = FMath::RadiansToDegrees(LastTransform.GetRotation().AngularDistance(CurrentTransform.GetRotation()));
+	const int32 Substeps = FMath::Clamp(FMath::CeilToInt(Angle / MaxSubstepAngle), 1, MaxSubsteps);
+
+	FTransform From = LastTransform;
+	for (int32 Step = 1; Step <= Substeps; Step++)
+	{
+		FTransform To;
+		To.Blend(LastTransform, CurrentTransform, (float)Step / Substeps);
+		Sweep(From, To);
+		From = To;
+	}
+
+	LastTransform = CurrentTransform;
+	DeliverHits();
+}
+
+void UMeleeTraceComponent::Sweep(const FTransform& From, const FTransform& To)
+{
+	INC_DWORD_STAT(STAT_VenariMeleeSweeps);
+
+	// Use the box's collision responses, everything it would block is reported as a hit too
+	FCollisionResponseParams ResponseParams(TraceBox->GetCollisionResponseToChannels());
+	ResponseParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MeleeTrace), false, GetOwner());
+
+	SweepScratch.Reset();
+	GetWorld()->SweepMultiByChannel(SweepScratch, From.GetLocation(), To.GetLocation(), To.GetRotation(),
+		TraceBox->GetCollisionObjectType(), FCollisionShape::MakeBox(TraceBox->GetScaledBoxExtent()), QueryParams, ResponseParams);
+
+	// Multi component actors are only hit once
+	for (const FHitResult& Hit : SweepScratch)
+	{
+		AActor* HitActor = Hit.GetActor();
+		if (HitActor == nullptr)
+			continue;
+
+		bool bAlreadyHit;
+		SwingHits.Add(HitActor, &bAlreadyHit);
+		if (!bAlreadyHit)
+			NewHits.Add(HitActor);
+	}
+}
+
+void UMeleeTraceComponent::DeliverHits()
+{
+	if (NewHits.Num() <= 0)
+		return;
+
+	INC_DWORD_STAT_BY(STAT_VenariMeleeHits, NewHits.Num());
+
+	// Delegate might begin a new swing, deliver a copy
+	TArray<AActor*> Hits = MoveTemp(NewHits);
+	NewHits.Reset();
+	OnHits.ExecuteIfBound(Hits);
+}
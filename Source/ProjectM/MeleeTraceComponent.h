@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MeleeTraceComponent.generated.h"
+
+class UBoxComponent;
+
+DECLARE_DELEGATE_OneParam(FMeleeHitsDelegate, const TArray<AActor*>& /*HitActors*/);
+
+/**
+ * Sweeps a melee box between its last two frame transforms while a swing is active.
+ * Every actor is reported once per swing, the new hits of a frame are delivered together in a single list.
+ * The box only provides the shape and collision responses, it never needs collision or overlap events enabled.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class PROJECTM_API UMeleeTraceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UMeleeTraceComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void SetTraceBox(UBoxComponent* Box); // Box to sweep, usually attached to the weapon's socket
+
+	void BeginSwing(); // Clear the swing's hits and start sweeping
+	void EndSwing(); // Stop sweeping
+	bool IsSwinging() const { return bSwinging; }
+
+	FMeleeHitsDelegate OnHits; // New hits of a frame, each actor only once per swing
+
+private:
+	UPROPERTY(Transient)
+		UBoxComponent* TraceBox;
+
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (ClampMin = "1.0"))
+		float MaxSubstepAngle = 20.0f; // Degrees the box can rotate between two sweeps, fast swings are split in substeps
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (ClampMin = "1"))
+		int32 MaxSubsteps = 4;
+
+	bool bSwinging = false;
+	FTransform LastTransform; // Box transform at the end of the last sweep
+
+	TSet<TWeakObjectPtr<AActor>> SwingHits; // Actors already hit during this swing
+	TArray<AActor*> NewHits; // Actors first hit this frame
+	TArray<FHitResult> SweepScratch;
+
+	void Sweep(const FTransform& From, const FTransform& To); // Collect new hits along the box's movement
+	void DeliverHits();
+};
@@ -64,4 +64,30 @@ UENUM(BlueprintType)
 enum class EPlayerCharacter : uint8 {
 	AGILE = 0 UMETA(DisplayName = "Agile"),
 	BERSERKER = 1 UMETA(DisplayName = "Berserker"),
-};
\ No newline at end of file
+};
+
+UENUM(BlueprintType)
+enum class EEnemySignificance : uint8 {
+	ENGAGED = 0 UMETA(DisplayName = "Engaged"), // Fighting or close to the player, updated at full rate
+	VISIBLE = 1 UMETA(DisplayName = "Visible"), // On screen, updated at full rate with animation rate optimizations
+	DISTANT = 2 UMETA(DisplayName = "Distant"), // Far on screen or close off screen, ticks and AI throttled
+	DORMANT = 3 UMETA(DisplayName = "Dormant"), // Far off screen, AI paused and animation only when rendered
+	MAX = 4 UMETA(Hidden),
+};
+
+
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EActorCategory : uint8 {
+	NONE = 0 UMETA(Hidden),
+	ENEMY = 1 << 0 UMETA(DisplayName = "Enemy"),
+	PLAYER = 1 << 1 UMETA(DisplayName = "Player"),
+	PLACEABLE_SURFACE = 1 << 2 UMETA(DisplayName = "Placeable Surface"), // Items can be placed on it
+	DESTRUCTABLE = 1 << 3 UMETA(DisplayName = "Destructable"),
+};
+ENUM_CLASS_FLAGS(EActorCategory);
+
+UENUM(BlueprintType)
+enum class EQuestEventType : uint8 {
+	KILL = 0 UMETA(DisplayName = "Kill"), // Target is the monster's name
+	COLLECT = 1 UMETA(DisplayName = "Collect"), // Target is the item's name
+};
@@ -55,6 +55,19 @@ struct FMonsterHints : public FTableRowBase
 		FString Description;
 };
 
+USTRUCT(BlueprintType)
+struct FQuestObjective
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+		EQuestEventType Type = EQuestEventType::KILL;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+		FName Target; // Monster, item or character name
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest", meta = (ClampMin = "1"))
+		int32 Count = 1; // Events needed to complete the objective
+};
+
 USTRUCT(Blueprintable)
 struct FQuestInfo : public FTableRowBase
 {
@@ -66,6 +79,8 @@ struct FQuestInfo : public FTableRowBase
 		FString Description;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
 		class UTexture2D* Icon;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
+		TArray<FQuestObjective> Objectives; // The quest completes once every objective is done
 };
 
 USTRUCT(Blueprintable)
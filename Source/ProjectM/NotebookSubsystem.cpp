@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NotebookSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+void FMonsterHintIndex::Reset()
+{
+	NumMonsters = 0;
+	NumWords = 0;
+	AllMonsters.Reset();
+	FootprintsBits.Reset();
+	FurBits.Reset();
+	ResidueBits.Reset();
+}
+
+void FMonsterHintIndex::Build(const TArray<FMonsterData>& Monsters)
+{
+	Reset();
+
+	NumMonsters = Monsters.Num();
+	NumWords = FMath::DivideAndRoundUp(NumMonsters, 64);
+	AllMonsters.SetNumZeroed(NumWords);
+
+	for (int32 Monster = 0; Monster < NumMonsters; Monster++)
+	{
+		AllMonsters[Monster / 64] |= 1ull << (Monster % 64);
+		SetBit(FootprintsBits, NumWords, (uint8)Monsters[Monster].FootprintsHint, Monster);
+		SetBit(FurBits, NumWords, (uint8)Monsters[Monster].FurHint, Monster);
+		SetBit(ResidueBits, NumWords, (uint8)Monsters[Monster].ResidueHint, Monster);
+	}
+}
+
+// Bitsets grow to the highest hint value in the data
+void FMonsterHintIndex::SetBit(TArray<uint64>& Bits, int32 NumWords, uint8 Value, int32 Monster)
+{
+	const int32 Needed = ((int32)Value + 1) * NumWords;
+	if (Bits.Num() < Needed)
+		Bits.AddZeroed(Needed - Bits.Num());
+
+	Bits[(int32)Value * NumWords + Monster / 64] |= 1ull << (Monster % 64);
+}
+
+const uint64* FMonsterHintIndex::GetBits(const TArray<uint64>& Bits, uint8 Value) const
+{
+	if (Value == 0)
+		return AllMonsters.GetData();
+
+	return ((int32)Value + 1) * NumWords <= Bits.Num() ? Bits.GetData() + (int32)Value * NumWords : nullptr;
+}
+
+template<typename FunctionType>
+void FMonsterHintIndex::ForEachCandidateWord(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, FunctionType Function) const
+{
+	const uint64* FootprintsWords = GetBits(FootprintsBits, (uint8)Footprints);
+	const uint64* FurWords = GetBits(FurBits, (uint8)Fur);
+	const uint64* ResidueWords = GetBits(ResidueBits, (uint8)Residue);
+	if (!FootprintsWords || !FurWords || !ResidueWords)
+		return;
+
+	for (int32 Word = 0; Word < NumWords; Word++)
+	{
+		const uint64 Candidates = FootprintsWords[Word] & FurWords[Word] & ResidueWords[Word];
+		if (Candidates)
+			Function(Word, Candidates);
+	}
+}
+
+void FMonsterHintIndex::FindCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, TArray<int32>& OutMonsters) const
+{
+	OutMonsters.Reset();
+	ForEachCandidateWord(Footprints, Fur, Residue, [&OutMonsters](int32 Word, uint64 Candidates)
+	{
+		while (Candidates)
+		{
+			OutMonsters.Add(Word * 64 + (int32)FPlatformMath::CountTrailingZeros64(Candidates));
+			Candidates &= Candidates - 1;
+		}
+	});
+}
+
+int32 FMonsterHintIndex::CountCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue) const
+{
+	int32 Count = 0;
+	ForEachCandidateWord(Footprints, Fur, Residue, [&Count](int32 Word, uint64 Candidates)
+	{
+		Count += (int32)FPlatformMath::CountBits(Candidates);
+	});
+	return Count;
+}
+
+void UNotebookSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency(UGameDataSubsystem::StaticClass());
+	GameData = GetGameInstance()->GetSubsystem<UGameDataSubsystem>();
+
+	Index.Build(GameData->GetMonsters());
+}
+
+void UNotebookSubsystem::Deinitialize()
+{
+	Index.Reset();
+	GameData = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UNotebookSubsystem::FindCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, TArray<FName>& OutMonsters) const
+{
+	TArray<int32> Candidates;
+	Index.FindCandidates(Footprints, Fur, Residue, Candidates);
+
+	OutMonsters.Reset(Candidates.Num());
+	for (int32 Monster : Candidates)
+		OutMonsters.Add(GameData->GetMonster(Monster)->Row);
+}
+
+#if !UE_BUILD_SHIPPING
+
+// Index queries against filtering every monster, on a generated bestiary
+// Usage: Venari.BenchNotebookQuery [Monsters] [Queries]
+static FAutoConsoleCommand BenchNotebookQueryCommand(
+	TEXT("Venari.BenchNotebookQuery"),
+	TEXT("Times FMonsterHintIndex against filtering every monster. Args: [Monsters=4096] [Queries=100000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumMonsters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 4096;
+		const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+
+		FRandomStream Random(1234);
+		TArray<FMonsterData> Monsters;
+		Monsters.SetNum(NumMonsters);
+		for (FMonsterData& Monster : Monsters)
+		{
+			Monster.FootprintsHint = (EFootprintsHint)Random.RandRange(0, (int32)EFootprintsHint::LINES);
+			Monster.FurHint = (EFurHint)Random.RandRange(0, (int32)EFurHint::SCALES);
+			Monster.ResidueHint = (EResidueHint)Random.RandRange(0, (int32)EResidueHint::ACID);
+		}
+
+		FMonsterHintIndex Index;
+		double StartTime = FPlatformTime::Seconds();
+		Index.Build(Monsters);
+		const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+		// Discovered hints, unknown about a quarter of the time
+		struct FQuery { EFootprintsHint Footprints; EFurHint Fur; EResidueHint Residue; };
+		TArray<FQuery> Queries;
+		for (int32 i = 0; i < NumQueries; i++)
+		{
+			Queries.Add({
+				Random.FRand() < 0.25f ? EFootprintsHint::UNKNOWN : (EFootprintsHint)Random.RandRange(1, (int32)EFootprintsHint::LINES),
+				Random.FRand() < 0.25f ? EFurHint::UNKNOWN : (EFurHint)Random.RandRange(1, (int32)EFurHint::SCALES),
+				Random.FRand() < 0.25f ? EResidueHint::UNKNOWN : (EResidueHint)Random.RandRange(1, (int32)EResidueHint::ACID) });
+		}
+
+		int64 ScanTotal = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (const FQuery& Query : Queries)
+		{
+			for (const FMonsterData& Monster : Monsters)
+			{
+				if ((Query.Footprints == EFootprintsHint::UNKNOWN || Monster.FootprintsHint == Query.Footprints) &&
+					(Query.Fur == EFurHint::UNKNOWN || Monster.FurHint == Query.Fur) &&
+					(Query.Residue == EResidueHint::UNKNOWN || Monster.ResidueHint == Query.Residue))
+					ScanTotal++;
+			}
+		}
+		const double ScanTime = FPlatformTime::Seconds() - StartTime;
+
+		int64 IndexTotal = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (const FQuery& Query : Queries)
+			IndexTotal += Index.CountCandidates(Query.Footprints, Query.Fur, Query.Residue);
+		const double IndexTime = FPlatformTime::Seconds() - StartTime;
+
+		TArray<int32> Candidates;
+		int64 FindTotal = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (const FQuery& Query : Queries)
+		{
+			Index.FindCandidates(Query.Footprints, Query.Fur, Query.Residue, Candidates);
+			FindTotal += Candidates.Num();
+		}
+		const double FindTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogTemp, Display, TEXT("Notebook query, %d monsters x %d queries: build %.3f ms, scan %.3f ms, index count %.3f ms (x%.2f), index find %.3f ms. Results %s."),
+			NumMonsters, NumQueries, BuildTime * 1000.0, ScanTime * 1000.0, IndexTime * 1000.0, IndexTime > 0.0 ? ScanTime / IndexTime : 0.0,
+			FindTime * 1000.0, ScanTotal == IndexTotal && ScanTotal == FindTotal ? TEXT("match") : TEXT("DIFFER"));
+	}));
+
+#endif
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameDataSubsystem.h"
+#include "NotebookSubsystem.generated.h"
+
+/**
+ * Bitsets of monsters for every hint value, candidates for a set of discovered hints are the AND of their bitsets.
+ * Unknown hints don't filter, monsters whose hint is unknown only match when that hint isn't discovered.
+ */
+struct PROJECTM_API FMonsterHintIndex
+{
+	void Build(const TArray<FMonsterData>& Monsters); // Indices are the monsters' game data IDs
+	void Reset();
+
+	// Indices of the monsters matching the hints, in build order
+	void FindCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, TArray<int32>& OutMonsters) const;
+	int32 CountCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue) const;
+
+	int32 Num() const { return NumMonsters; }
+
+private:
+	int32 NumMonsters = 0;
+	int32 NumWords = 0; // 64 monsters per word
+
+	TArray<uint64> AllMonsters;
+	TArray<uint64> FootprintsBits; // NumWords words per hint value
+	TArray<uint64> FurBits;
+	TArray<uint64> ResidueBits;
+
+	static void SetBit(TArray<uint64>& Bits, int32 NumWords, uint8 Value, int32 Monster);
+	const uint64* GetBits(const TArray<uint64>& Bits, uint8 Value) const; // All monsters if unknown, null if no monster has the value
+
+	template<typename FunctionType>
+	void ForEachCandidateWord(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, FunctionType Function) const;
+};
+
+/**
+ * Monster notebook queries, the game data's monsters are indexed once when the game starts.
+ */
+UCLASS()
+class PROJECTM_API UNotebookSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Notebook")
+		void FindCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue, TArray<FName>& OutMonsters) const; // Rows of the monster hints data table matching the discovered hints
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+		int32 CountCandidates(EFootprintsHint Footprints, EFurHint Fur, EResidueHint Residue) const { return Index.CountCandidates(Footprints, Fur, Residue); }
+
+private:
+	UPROPERTY()
+		UGameDataSubsystem* GameData;
+
+	FMonsterHintIndex Index;
+};
@@ -24,6 +24,13 @@
 #include "Kismet/GameplayStatics.h"
 #include "Components/StaticMeshComponent.h"
 #include "SoundManager.h"
+#include "TraceSchedulerSubsystem.h"
+#include "AbilityComponent.h"
+#include "MeleeTraceComponent.h"
+#include "InteractableSubsystem.h"
+#include "ActorCategoryComponent.h"
+#include "ActorCategorySubsystem.h"
+#include "InventorySubsystem.h"
 
 //////////////////////////////////////////////////////////////////////////
 // APlayerCharacter
@@ -62,6 +69,9 @@ APlayerCharacter::APlayerCharacter()
 	// Create a health component
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
 
+	// Create category component
+	CategoryComponent = CreateDefaultSubobject<UActorCategoryComponent>(TEXT("CategoryComponent"));
+
 
 	// Create Weapon Mesh
 	Weapon = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Weapon Mesh"));
@@ -71,12 +81,18 @@ APlayerCharacter::APlayerCharacter()
 	MeleeTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("Melee Trigger"));
 	MeleeTrigger->SetupAttachment(Weapon);
 	MeleeTrigger->bEditableWhenInherited = true;
+
+	// Create melee trace component
+	MeleeTrace = CreateDefaultSubobject<UMeleeTraceComponent>(TEXT("MeleeTrace"));
 	
 	// Create melee trigger box
 	InteractionTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("Interaction Trigger"));
 	InteractionTrigger->SetupAttachment(RootComponent);
 	InteractionTrigger->bEditableWhenInherited = true;
 
+	// Create ability component
+	AbilityComponent = CreateDefaultSubobject<UAbilityComponent>(TEXT("AbilityComponent"));
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 }
@@ -87,12 +103,23 @@ void APlayerCharacter::BeginPlay()
 	// Set initial gravity to character movement's value
 	bPossessed = (GetController()->GetNetOwningPlayer() != nullptr);
 
-	MeleeTrigger->OnComponentBeginOverlap.AddDynamic(this, &APlayerCharacter::OnMeleeBoxBeginOverlap);	
+	// Melee trigger is only swept, it doesn't need to collide
+	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeleeTrace->SetTraceBox(MeleeTrigger);
+	MeleeTrace->OnHits.BindUObject(this, &APlayerCharacter::OnMeleeHits);
 
-	InteractionTrigger->OnComponentBeginOverlap.AddDynamic(this, &APlayerCharacter::OnInteractionBoxBeginOverlap);
-	InteractionTrigger->OnComponentEndOverlap.AddDynamic(this, &APlayerCharacter::OnInterationBoxOverlapEnd);
+	// Interactables are queried from the registry, the trigger only defines the box they must overlap
+	InteractionTrigger->SetGenerateOverlapEvents(false);
+
+	// Abilities move the character, tick them before the movement component
+	GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(AbilityComponent, AbilityComponent->PrimaryComponentTick);
 
 	GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+	TraceScheduler = GetWorld()->GetSubsystem<UTraceSchedulerSubsystem>();
+	Cooldowns = GetWorld()->GetSubsystem<UCooldownSubsystem>();
+	InteractableRegistry = GetWorld()->GetSubsystem<UInteractableSubsystem>();
+	ActorCategories = GetWorld()->GetSubsystem<UActorCategorySubsystem>();
+	Inventory = GetGameInstance()->GetSubsystem<UInventorySubsystem>();
 
 	SetNotebookVisibility(false);
 	bIsNotebookVisible = false;
@@ -104,7 +131,7 @@ void APlayerCharacter::Tick(float DeltaSeconds)
 
 	PossessCamMovement(DeltaSeconds);
 	PlacingItem();
-	TickStopAttackStreak(DeltaSeconds);
+	UpdateCurrentInteractable();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -259,11 +286,11 @@ void APlayerCharacter::TakeDamage(float Amount)
 	if (!HealthComponent->IsDead())
 	{
 		GetMesh()->GetAnimInstance()->Montage_Play(HitMontage);
-		SoundManager::PlayRandomSoundAtLocation(GetWorld(), DamagedSfx, GetActorLocation());
+		GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(DamagedSfx, GetActorLocation());
 	}
 	else
 	{
-		SoundManager::PlayRandomSoundAtLocation(GetWorld(), DeathSfx, GetActorLocation());
+		GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(DeathSfx, GetActorLocation());
 		SetInventoryVisibility(false);
 		SetNotebookVisibility(false);
 	}
@@ -312,6 +339,7 @@ void APlayerCharacter::MeleeAttackAction()
 		PlayAttackMontage(0);
 		bInCombo = true;
 		CurrentAttackString = 0;
+		Cooldowns->CancelCooldown(AttackStreakHandle);
 		// SetCanCombo(true);
 	}
 }
@@ -347,9 +375,12 @@ void APlayerCharacter::EndAttackAnimation()
 		CurrentAttackString = 0;
 	}
 
-	// If there's a special attack queued, return to trigger special attack
+	// If there's a special attack queued, trigger it instead of continuing the combo
 	if (bQueuedSpecialAttack)
+	{
+		BeginQueuedSpecialAttack();
 		return;
+	}
 
 	// Continue combo if input was given and conditions were met
 	if (bContinueCombo)
@@ -367,6 +398,15 @@ void APlayerCharacter::QueueSpecialAttack()
 	bQueuedSpecialAttack = true;
 	bContinueCombo = false;
 	SetCanCombo(false);
+
+	// If it's not attacking, there's no animation end to wait for
+	if (!bInAttackAnimation)
+		BeginQueuedSpecialAttack();
+}
+
+// Starts the queued special attack, implemented by characters with special attacks
+void APlayerCharacter::BeginQueuedSpecialAttack()
+{
 }
 
 // Enable and disable input to continue combos
@@ -375,38 +415,51 @@ void APlayerCharacter::SetCanCombo(bool _CanCombo)
 	bCanCombo = _CanCombo;
 }
 
-// Enable melee box in animation
+// Start melee sweep in animation
 void APlayerCharacter::BeginAttack()
 {
-	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	MeleeTrace->BeginSwing();
 }
 
-// Disable melee box in animation
+// Stop melee sweep in animation
 void APlayerCharacter::EndAttack()
 {
-	MeleeTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeleeTrace->EndSwing();
 }
 
-// Handle actors overlapping attack trigger to deal damage
-void APlayerCharacter::OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, 
-	int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+// Handle actors hit by the attack to deal damage, each actor is only hit once per attack
+void APlayerCharacter::OnMeleeHits(const TArray<AActor*>& HitActors)
 {
-	if (!OtherActor || OtherActor == this)
-		return;
+	DealMeleeDamage(HitActors);
+}
 
-	if (OtherActor->ActorHasTag(TEXT("Enemy")))
+// Hits include the level geometry the swing went through, only enemies are damaged
+int32 APlayerCharacter::DealMeleeDamage(const TArray<AActor*>& HitActors)
+{
+	int32 NumDamaged = 0;
+	for (AActor* OtherActor : HitActors)
 	{
-		if (Cast<AEnemy>(OtherActor) == nullptr)
-			return;
-		
-		Cast<AEnemy>(OtherActor)->TakeDamage(Damage);
-		SoundManager::PlayRandomSoundAtLocation(GetWorld(), ImpactSfx, GetActorLocation());
+		if (!IsValid(OtherActor) || OtherActor == this)
+			continue;
+
+		AEnemy* Enemy = ActorCategories->GetEnemy(OtherActor);
+		if (Enemy == nullptr || Enemy->HealthComponent->IsDead())
+			continue;
+
+		Enemy->TakeDamage(Damage);
+		NumDamaged++;
+		GetWorld()->GetSubsystem<USoundManager>()->QueueRandomSoundAtLocation(ImpactSfx, GetActorLocation());
 
 		// Increase current attack streak
-		// Reset timer to stop streak
+		// Reset timer to stop streak, it only runs outside of combos
 		CurrentAttackString++;
-		currentTimeToStopAttackStreak = timeToStopAttackStreak;
+		if (bInCombo)
+			Cooldowns->CancelCooldown(AttackStreakHandle);
+		else
+			StartAttackStreakTimer();
 	}
+
+	return NumDamaged;
 }
 // Play given animation from animation attack array
 void APlayerCharacter::PlayAttackMontage(int Index)
@@ -434,20 +487,20 @@ void APlayerCharacter::StopCombo()
 	bContinueCombo = false; bInCombo = false;
 	SetCanCombo(false);
 	EndAttack();
+
+	if (CurrentAttackString > 0)
+		StartAttackStreakTimer();
 }
 
-// Demish ending combo timer, after which it'll stop the combo
-void APlayerCharacter::TickStopAttackStreak(float DeltaTime)
+// Start ending combo timer, after which it'll stop the streak
+void APlayerCharacter::StartAttackStreakTimer()
 {
-	if (CurrentAttackString <= 0 || bInCombo)
-		return;
-	
-	if (currentTimeToStopAttackStreak > 0)
-	{
-		currentTimeToStopAttackStreak -= DeltaTime;
-		return;
-	}
+	Cooldowns->RestartCooldown(AttackStreakHandle, timeToStopAttackStreak,
+		FCooldownExpiredDelegate::CreateUObject(this, &APlayerCharacter::StopAttackStreak));
+}
 
+void APlayerCharacter::StopAttackStreak()
+{
 	CurrentAttackString = 0;
 }
 
@@ -509,84 +562,28 @@ void APlayerCharacter::Play2DSound(USoundBase* Sound, float VolumeMultiplier, fl
 	UGameplayStatics::PlaySound2D(GetWorld(), Sound, VolumeMultiplier, PitchMultiplier);
 }
 
-// Checks if an new interactable enters the range
-void APlayerCharacter::OnInteractionBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	if (!bPossessed || bPossessing)
-		return;
-	
-	if (OtherActor == this)
-		return;
-
-	if (OtherActor->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
-	{
-		CheckCurrentInteractable(OtherActor);
-		return;
-	}
-
-	TArray<UActorComponent*> Components;
-	OtherActor->GetComponents(Components);
-	for (int i = 0; i < Components.Num(); i++)
-	{
-		if (Components[i]->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
-		{
-			CheckCurrentInteractable(Components[i]);
-			return;
-		}
-	}
-}
-
-// Checks if a detected interactable leaves range
-void APlayerCharacter::OnInterationBoxOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+// Single registry query for the closest interactable in range
+void APlayerCharacter::UpdateCurrentInteractable()
 {
-	if (!bPossessed || bPossessing)
-		return;
-
-	if (OtherActor == this)
-		return;
-
-	if (OtherActor->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
-	{
-		DisableInteractable(OtherActor);
-		if (CurrentInteractable == OtherActor)
-			CurrentInteractable = nullptr;
-	}
-
-	TArray<UActorComponent*> Components;
-	OtherActor->GetComponents(Components);
-	for (int i = 0; i < Components.Num(); i++)
-	{
-		if (Components[i]->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
-		{
-			DisableInteractable(Components[i]);
-			if (CurrentInteractable == Components[i])
-				CurrentInteractable = nullptr;
-		}
-	}	
-}
+	UObject* ClosestInteractable = nullptr;
+	IInteractionInterface* ClosestInterface = nullptr;
 
-void APlayerCharacter::CheckCurrentInteractable(UObject* Interactable)
-{
-	if (!CurrentInteractable)
+	// Only the controlled character looks for interactables
+	if (bPossessed && !bPossessing && InteractableRegistry)
 	{
-		CurrentInteractable = Interactable;
-		EnableInteractable(CurrentInteractable);
-		return;
+		ClosestInteractable = InteractableRegistry->FindClosestInteractable(InteractionTrigger->GetComponentTransform(),
+			InteractionTrigger->GetUnscaledBoxExtent(), this, ClosestInterface);
 	}
 
-	AActor* NewInteractableActor = Cast<AActor>(Interactable);
-	if (!NewInteractableActor)
+	if (ClosestInteractable == CurrentInteractable)
 		return;
 
-	AActor* CurrentInteractableActor = Cast<AActor>(Interactable);
+	if (IsValid(CurrentInteractable))
+		DisableInteractable(CurrentInteractable, CurrentInteractionInterface);
 
-	if (!CurrentInteractableActor || FVector::Dist(NewInteractableActor->GetActorLocation(), GetActorLocation()) < FVector::Dist(CurrentInteractableActor->GetActorLocation(), GetActorLocation()))
-	{
-		DisableInteractable(CurrentInteractable);
-		CurrentInteractable = Interactable;
-		EnableInteractable(CurrentInteractable);
-		return;
-	}
+	CurrentInteractable = ClosestInteractable;
+	CurrentInteractionInterface = ClosestInterface;
+	EnableInteractable(CurrentInteractable, CurrentInteractionInterface);
 }
 
 // Interact with the interactable closer to the player
@@ -596,72 +593,63 @@ void APlayerCharacter::InteractAction()
 		return;
 
 	EndUpperBoddyMontage();
-	UseInteractable(CurrentInteractable);
+	UseInteractable(CurrentInteractable, CurrentInteractionInterface);
 }
 
-void APlayerCharacter::UseInteractable(UObject* InteractableObj)
+void APlayerCharacter::UseInteractable(UObject* InteractableObj, IInteractionInterface* Interface)
 {
-	// If the closest reference isn't valid run the function again
-	if (InteractableObj == nullptr)
-	{
+	if (!IsValid(InteractableObj))
 		return;
-	}
 
 	// Execute closest interactable's action (BLUEPRINT)
-	DisableInteractable(InteractableObj);
+	DisableInteractable(InteractableObj, Interface);
 	IInteractionInterface::Execute_OnInteraction(InteractableObj, this);
 
-	// Check if object was deleted during it's action call
-	if (InteractableObj == nullptr)
+	// Check if object was destroyed during it's action call
+	if (!IsValid(InteractableObj) || !Interface)
 		return;
 
 	// Execute closest interactable's action (CPP)
-	IInteractionInterface* CurrentInteractionInterface = Cast<IInteractionInterface>(InteractableObj);
-	if (!CurrentInteractionInterface)
-		return;
-
-	CurrentInteractionInterface->OnDisableCPP();
-	CurrentInteractionInterface->OnInteractionCPP(this);
+	Interface->OnDisableCPP();
+	Interface->OnInteractionCPP(this);
 }
 
-void APlayerCharacter::EnableInteractable(UObject* InteractableObj)
+void APlayerCharacter::EnableInteractable(UObject* InteractableObj, IInteractionInterface* Interface)
 {
-	if (InteractableObj == nullptr)
-	{
+	if (!IsValid(InteractableObj))
 		return;
-	}
 
 	IInteractionInterface::Execute_OnEnable(InteractableObj);
 
-	// Check if object was deleted during it's action call
-	if (InteractableObj == nullptr)
-		return;
-
-	IInteractionInterface* CurrentInteractionInterface = Cast<IInteractionInterface>(InteractableObj);
-	if (!CurrentInteractionInterface)
+	// Check if object was destroyed during it's action call
+	if (!IsValid(InteractableObj) || !Interface)
 		return;
 
-	CurrentInteractionInterface->OnEnableCPP();
+	Interface->OnEnableCPP();
 }
 
-void APlayerCharacter::DisableInteractable(UObject* InteractableObj)
+void APlayerCharacter::DisableInteractable(UObject* InteractableObj, IInteractionInterface* Interface)
 {
-	if (InteractableObj == nullptr)
-	{
+	if (!IsValid(InteractableObj))
 		return;
-	}
 
 	IInteractionInterface::Execute_OnDisable(InteractableObj);
 
-	// Check if object was deleted during it's action call
-	if (InteractableObj == nullptr)
+	// Check if object was destroyed during it's action call
+	if (!IsValid(InteractableObj) || !Interface)
 		return;
 
-	IInteractionInterface* CurrentInteractionInterface = Cast<IInteractionInterface>(InteractableObj);
-	if (!CurrentInteractionInterface)
-		return;
+	Interface->OnDisableCPP();
+}
 
-	CurrentInteractionInterface->OnDisableCPP();
+bool APlayerCharacter::AddItem_Implementation(FItemStruct Item, int Quantity)
+{
+	return Inventory->AddItem(Item.Name, Quantity);
+}
+
+bool APlayerCharacter::RemoveItem_Implementation(FItemStruct Item, int Quantity)
+{
+	return Inventory->RemoveItem(Item.Name, Quantity);
 }
 
 // Uses or starts placing equipped item, depending on its type
@@ -670,42 +658,76 @@ void APlayerCharacter::ItemAction()
 	if (bPossessing || bIsNotebookVisible || bInAttackAnimation)
 		return;
 
-	FItemStruct Item = GameInstance->InventoryData[GameInstance->EquippedItemIndex];
-
 	// If no item is equipped, do nothing
-	if (Item.Name.IsNone())
+	const FItemStruct* Item = Inventory->GetSlotItem(GameInstance->EquippedItemIndex);
+	if (!Item)
 		return;
 
 	// If no item actor is set, do nothing
-	if (!Item.ItemActor)
+	if (!Item->ItemActor)
 		return;
 
-	switch (Item.Type)
+	switch (Item->Type)
 	{
 		case EItemType::CONSUMABLE:
-			Item.ItemActor.GetDefaultObject()->UseItem(this);
+			Item->ItemActor.GetDefaultObject()->UseItem(this);
 			break;
 
 		case EItemType::PLACEABLE:
+		{
 			// Line trace to check the place to spawn the item
+			const FVector TraceStart = FollowCamera->GetComponentLocation();
+			const FVector TraceEnd = TraceStart + FollowCamera->GetForwardVector() * PlacingDistance;
+
+			// Item is spawned once the trace comes back next frame
+			if (TraceScheduler)
+			{
+				PendingPlacingItem = Item->ItemActor;
+				ItemPlacementRequestId = TraceScheduler->RequestLineTrace(TraceStart, TraceEnd, ECC_Visibility, FCollisionQueryParams::DefaultQueryParam,
+					FScheduledTraceDelegate::CreateUObject(this, &APlayerCharacter::OnItemPlacementTrace));
+				break;
+			}
+
 			FHitResult LineHit;
-			GetWorld()->LineTraceSingleByChannel(LineHit, FollowCamera->GetComponentLocation(),
-				FollowCamera->GetComponentLocation() + FollowCamera->GetForwardVector() * PlacingDistance, ECC_Visibility);
+			GetWorld()->LineTraceSingleByChannel(LineHit, TraceStart, TraceEnd, ECC_Visibility);
+			SpawnPlacingItem(Item->ItemActor, LineHit);
+			break;
+		}
+	}
+}
+
+// Spawn the pending item if its placement trace hit a valid location
+void APlayerCharacter::OnItemPlacementTrace(uint64 RequestId, const FTraceDatum& TraceDatum)
+{
+	// Ignore results from outdated traces
+	if (RequestId != ItemPlacementRequestId)
+		return;
 
-			if (!LineHit.GetActor() || !LineHit.GetActor()->ActorHasTag("AllowedPlacing"))
-				return;
+	TSubclassOf<AItemActor> ItemClass = PendingPlacingItem;
+	PendingPlacingItem = nullptr;
+	ItemPlacementRequestId = 0;
 
-			if (FVector::DotProduct(LineHit.ImpactNormal, FVector::UpVector) < PlacingDotProductThreshold)
-				return;
+	// The player state might have changed while the trace was running
+	if (bPossessing || bIsNotebookVisible || bInAttackAnimation)
+		return;
 
-			FVector Location = LineHit.ImpactPoint;
-			FRotator Rotation = GetCapsuleComponent()->GetComponentRotation();
-			FActorSpawnParameters SpawnParams;
+	SpawnPlacingItem(ItemClass, TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult());
+}
 
-			// Spawn item to start placing
-			PlacingActorRef = GetWorld()->SpawnActor<AItemActor>(Item.ItemActor, Location, Rotation, SpawnParams);
-			break;
-	}
+void APlayerCharacter::SpawnPlacingItem(TSubclassOf<AItemActor> ItemClass, const FHitResult& LineHit)
+{
+	if (!ItemClass)
+		return;
+
+	if (!IsValidPlacingHit(LineHit))
+		return;
+
+	FVector Location = LineHit.ImpactPoint;
+	FRotator Rotation = GetCapsuleComponent()->GetComponentRotation();
+	FActorSpawnParameters SpawnParams;
+
+	// Spawn item to start placing
+	PlacingActorRef = GetWorld()->SpawnActor<AItemActor>(ItemClass, Location, Rotation, SpawnParams);
 }
 
 // Activates PlacingActorRef and finishes placement
@@ -729,14 +751,40 @@ void APlayerCharacter::PlacingItem()
 	if (!PlacingActorRef)
 		return;
 
+	const FVector TraceStart = FollowCamera->GetComponentLocation();
+	const FVector TraceEnd = TraceStart + FollowCamera->GetForwardVector() * PlacingDistance;
+
+	// Item is moved once the trace comes back next frame, one trace in flight at a time so results arrive in order
+	if (TraceScheduler)
+	{
+		if (PlacingTraceRequestId == 0)
+			PlacingTraceRequestId = TraceScheduler->RequestLineTrace(TraceStart, TraceEnd, ECC_Visibility, FCollisionQueryParams::DefaultQueryParam,
+				FScheduledTraceDelegate::CreateUObject(this, &APlayerCharacter::OnPlacingTrace));
+		return;
+	}
+
 	FHitResult LineHit;
-	GetWorld()->LineTraceSingleByChannel(LineHit, FollowCamera->GetComponentLocation(),
-		FollowCamera->GetComponentLocation() + FollowCamera->GetForwardVector() * PlacingDistance, ECC_Visibility);
+	GetWorld()->LineTraceSingleByChannel(LineHit, TraceStart, TraceEnd, ECC_Visibility);
+	ApplyPlacingHit(LineHit);
+}
+
+void APlayerCharacter::OnPlacingTrace(uint64 RequestId, const FTraceDatum& TraceDatum)
+{
+	if (RequestId != PlacingTraceRequestId)
+		return;
+
+	PlacingTraceRequestId = 0;
 
-	if (!LineHit.GetActor() || !LineHit.GetActor()->ActorHasTag("AllowedPlacing"))
+	// Item might have been placed while the trace was running
+	if (!PlacingActorRef || TraceDatum.OutHits.Num() <= 0)
 		return;
 
-	if (FVector::DotProduct(LineHit.ImpactNormal, FVector::UpVector) < PlacingDotProductThreshold)
+	ApplyPlacingHit(TraceDatum.OutHits[0]);
+}
+
+void APlayerCharacter::ApplyPlacingHit(const FHitResult& LineHit)
+{
+	if (!IsValidPlacingHit(LineHit))
 		return;
 
 	PlacingActorRef->SetActorLocation(LineHit.ImpactPoint);
@@ -745,6 +793,15 @@ void APlayerCharacter::PlacingItem()
 	PlacingActorRef->SetActorRotation(Rotation);
 }
 
+// Items can only be placed on placeable surfaces that face up enough
+bool APlayerCharacter::IsValidPlacingHit(const FHitResult& LineHit) const
+{
+	if (!ActorCategories->HasAnyCategory(LineHit.GetActor(), EActorCategory::PLACEABLE_SURFACE))
+		return false;
+
+	return FVector::DotProduct(LineHit.ImpactNormal, FVector::UpVector) >= PlacingDotProductThreshold;
+}
+
 void APlayerCharacter::TickNotebookVisibility()
 {
 	bIsNotebookVisible = !bIsNotebookVisible;
@@ -6,11 +6,17 @@
 #include "GameFramework/Character.h"
 #include "MyStructs.h"
 #include "InteractionInterface.h"
+#include "WorldCollision.h"
+#include "CooldownSubsystem.h"
 #include "PlayerCharacter.generated.h"
 
 class AHookPoint;
 class UAnimMontage;
 class UCableComponent;
+class UTraceSchedulerSubsystem;
+class UInteractableSubsystem;
+class UActorCategorySubsystem;
+class UInventorySubsystem;
 
 UCLASS(config = Game)
 class APlayerCharacter : public ACharacter, public IInteractionInterface
@@ -32,14 +38,23 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 		class UHealthComponent* HealthComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+		class UActorCategoryComponent* CategoryComponent; // Categorizes the character as a player
+
 	UPROPERTY(EditDefaultsOnly)
 		class UStaticMeshComponent* Weapon;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* MeleeTrigger;
+		class UBoxComponent* MeleeTrigger; // Shape swept by the melee trace
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+		class UMeleeTraceComponent* MeleeTrace; // Sweeps the melee trigger box during attacks
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* InteractionTrigger;
+		class UBoxComponent* InteractionTrigger; // Interaction range, interactables are looked up around it
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+		class UAbilityComponent* AbilityComponent; // Ticks the character's abilities while they are active
 
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera)
@@ -106,6 +121,12 @@ protected:
 	virtual void BeginPlay() override;
 
 	class UVenariGameInstance* GameInstance;
+
+	UTraceSchedulerSubsystem* TraceScheduler = nullptr; // Batches scene queries, results come back next frame
+	UCooldownSubsystem* Cooldowns = nullptr; // Cooldowns and timers, kept as world time stamps
+	UInteractableSubsystem* InteractableRegistry = nullptr; // Spatial registry of the world's interactables
+	UActorCategorySubsystem* ActorCategories = nullptr; // Category bitmasks of the world's actors
+	UInventorySubsystem* Inventory = nullptr; // Item stacks, kept across levels
 	
 
 
@@ -122,9 +143,9 @@ public:
 	bool bQueuedSpecialAttack; // Has a special attack triggered to start right after current attack animation
 
 	UFUNCTION(BlueprintCallable)
-		void BeginAttack(); // Activate melee trigger box
+		void BeginAttack(); // Start sweeping the melee trigger box
 	UFUNCTION(BlueprintCallable)
-		void EndAttack(); // Deactivate melee trigget box
+		void EndAttack(); // Stop sweeping the melee trigger box
 	UFUNCTION(BlueprintCallable)
 		virtual void EndAttackAnimation(); // Check if should end attacks or continue combo, called at the end of an attack animation
 
@@ -139,9 +160,10 @@ public:
 
 protected:
 	virtual void MeleeAttackAction(); // Melee attack input
+	virtual void BeginQueuedSpecialAttack(); // Starts the queued special attack, called once the character is free to attack
 
-	UFUNCTION()
-		virtual void OnMeleeBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	virtual void OnMeleeHits(const TArray<AActor*>& HitActors); // Deal damage to the actors hit by the current attack
+	int32 DealMeleeDamage(const TArray<AActor*>& HitActors); // Damage the living enemies among the hit actors, returns how many were damaged
 
 	UPROPERTY(EditAnywhere)
 		float Damage = 25.0f; // Damage delt at each attack
@@ -170,8 +192,9 @@ private:
 
 	UPROPERTY(EditAnywhere)
 		float timeToStopAttackStreak = 1.0f; // Amount of seconds after which the combo will end
-	float currentTimeToStopAttackStreak;
-	void TickStopAttackStreak(float DeltaTime); // Demish ending combo timer, after which it'll stop the combo
+	FCooldownHandle AttackStreakHandle;
+	void StartAttackStreakTimer(); // Start ending combo timer, after which it'll stop the streak
+	void StopAttackStreak();
 
 	UPROPERTY(EditAnywhere, Category = "SFX")
 		TArray<USoundBase*> DeathSfx;
@@ -216,30 +239,27 @@ public:
 		void Play2DSound(USoundBase* Sound, float VolumeMultiplier = 1.0f, float PitchMultiplier = 1.0f);
 
 protected:
-	UFUNCTION()
-		virtual void OnInteractionBoxBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-	UFUNCTION()
-		void OnInterationBoxOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-	
 	UPROPERTY(BlueprintReadOnly)
 		UObject* CurrentInteractable;
-	void CheckCurrentInteractable(UObject* Interactable);
+	IInteractionInterface* CurrentInteractionInterface = nullptr; // Native interface of the current interactable, null if only implemented in blueprints
+	void UpdateCurrentInteractable(); // Enable the closest interactable in range, disable the previous one
 
 	virtual void InteractAction(); // Interact with the interactable closer to the player
 
 private:
-	void UseInteractable(UObject* InteractableObj);
-	void EnableInteractable(UObject* InteractableObj);
-	void DisableInteractable(UObject* InteractableObj);
+	void UseInteractable(UObject* InteractableObj, IInteractionInterface* Interface);
+	void EnableInteractable(UObject* InteractableObj, IInteractionInterface* Interface);
+	void DisableInteractable(UObject* InteractableObj, IInteractionInterface* Interface);
 
 
 
 	// ______INVENTORY_____
 public:
-	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
-		bool AddItem(FItemStruct Item, int Quantity); // Adds item to game instance
-	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
-		bool RemoveItem(FItemStruct Item, int Quantity); // Removes item to game instance
+	// Native events so the character blueprints' implementations keep compiling, their parent call adds to the inventory subsystem
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+		bool AddItem(FItemStruct Item, int Quantity); // Adds item to the inventory subsystem
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+		bool RemoveItem(FItemStruct Item, int Quantity); // Removes item from the inventory subsystem
 
 	UFUNCTION(BlueprintImplementableEvent)
 		void SetInventoryVisibility(bool bIsVisible); // Sets the visibility of the inventory tab
@@ -261,6 +281,15 @@ private:
 		float PlacingDistance = 1000.0f; // Max distance to place an item
 	class AItemActor* PlacingActorRef; // Instantiated item that is being placed
 	void PlacingItem(); // Sets the location and rotation of the item that is being placed
+	void OnPlacingTrace(uint64 RequestId, const FTraceDatum& TraceDatum); // Moves the item being placed to the traced location
+	void ApplyPlacingHit(const FHitResult& LineHit);
+	bool IsValidPlacingHit(const FHitResult& LineHit) const; // Can an item be placed at the hit location
+
+	TSubclassOf<class AItemActor> PendingPlacingItem; // Item to spawn once its placement trace comes back
+	uint64 ItemPlacementRequestId = 0;
+	uint64 PlacingTraceRequestId = 0; // Trace moving the placed item, a new one is only requested once it comes back
+	void OnItemPlacementTrace(uint64 RequestId, const FTraceDatum& TraceDatum); // Spawns the pending item at the traced location
+	void SpawnPlacingItem(TSubclassOf<class AItemActor> ItemClass, const FHitResult& LineHit);
 
 
 
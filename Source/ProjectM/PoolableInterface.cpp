@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PoolableInterface.h"
+
+// Add default functionality here for any IPoolableInterface functions that are not pure virtual.
+
+void IPoolableInterface::OnAcquiredFromPoolCPP()
+{
+	return;
+}
+
+void IPoolableInterface::OnReleasedToPoolCPP()
+{
+	return;
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PoolableInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI)
+class UPoolableInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors recycled by UActorPoolSubsystem, reset their state when acquired and park when released
+ */
+class PROJECTM_API IPoolableInterface
+{
+	GENERATED_BODY()
+
+	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
+public:
+	// BLUEPRINTS
+	UFUNCTION(Category = "Poolable Interface", BlueprintImplementableEvent)
+		void OnAcquired(); // Called after the actor is taken from the pool and placed
+	UFUNCTION(Category = "Poolable Interface", BlueprintImplementableEvent)
+		void OnReleased(); // Called after the actor is returned to the pool
+
+	// CPP
+	virtual void OnAcquiredFromPoolCPP(); // Reset state and become active again
+	virtual void OnReleasedToPoolCPP(); // Hide, stop ticking and logic, disable collision
+};
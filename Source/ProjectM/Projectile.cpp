@@ -6,20 +6,28 @@
 #include "Components/SphereComponent.h"
 #include "PlayerCharacter.h"
 #include "Enemy.h"
-#include "NiagaraFunctionLibrary.h"
+#include "VfxSubsystem.h"
 #include "SoundManager.h"
+#include "ActorPoolSubsystem.h"
+#include "ProjectileSubsystem.h"
+#include "ActorCategorySubsystem.h"
+#include "ProjectM.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live projectiles"), STAT_VenariLiveProjectiles, STATGROUP_Venari);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled projectiles"), STAT_VenariPooledProjectiles, STATGROUP_Venari);
 
 // Sets default values
 AProjectile::AProjectile()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Projectiles are moved in batch by the projectile subsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	SetRootComponent(Mesh);
 
 	Trigger = CreateDefaultSubobject<USphereComponent>(TEXT("Trigger"));
 	Trigger->SetupAttachment(Mesh);
+	Trigger->SetGenerateOverlapEvents(false); // Hits are found by the projectile subsystem's sweeps, the trigger only sets their radius
 }
 
 void AProjectile::Launch(FVector _Target, AActor* _VisualsRef, AActor* _Owner)
@@ -27,63 +35,92 @@ void AProjectile::Launch(FVector _Target, AActor* _VisualsRef, AActor* _Owner)
 	Target = _Target;
 	ProjectileVisuals = _VisualsRef;
 	OwnerActor = _Owner;
+
+	if (!bLaunched)
+		INC_DWORD_STAT(STAT_VenariLiveProjectiles);
+	bLaunched = true;
+
+	GetWorld()->GetSubsystem<UProjectileSubsystem>()->AddProjectile(this, Target, Speed, Trigger->GetScaledSphereRadius());
+}
+
+void AProjectile::OnAcquiredFromPoolCPP()
+{
+	DEC_DWORD_STAT(STAT_VenariPooledProjectiles);
+}
+
+void AProjectile::OnReleasedToPoolCPP()
+{
+	bLaunched = false;
+	ProjectileVisuals = nullptr;
+	OwnerActor = nullptr;
+
+	INC_DWORD_STAT(STAT_VenariPooledProjectiles);
 }
 
 // Called when the game starts or when spawned
 void AProjectile::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	Trigger->OnComponentBeginOverlap.AddDynamic(this, &AProjectile::OnBeginOverlap);
 
-	UE_LOG(LogTemp, Warning, TEXT("Spawned %s."), *GetName());
+	ActorCategories = GetWorld()->GetSubsystem<UActorCategorySubsystem>();
+	GetWorld()->GetSubsystem<UVfxSubsystem>()->Prewarm(ExplosionVfx, ExplosionVfxPrewarmCount);
 }
 
-// Called every frame
-void AProjectile::Tick(float DeltaTime)
+void AProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	GetWorld()->GetSubsystem<UProjectileSubsystem>()->RemoveProjectile(this);
 
-	Move(DeltaTime);
+	Super::EndPlay(EndPlayReason);
 }
 
-void AProjectile::OnBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+bool AProjectile::CanHit(const AActor* OtherActor) const
 {
-	if (OtherActor->ActorHasTag("Player"))
-	{
-		Cast<APlayerCharacter>(OtherActor)->TakeDamage(Damage);
-		Explode();
-	}
+	if (!bLaunched || OtherActor == nullptr)
+		return false;
 
-	if (OtherActor->ActorHasTag("Enemy") && OtherActor != OwnerActor)
-	{
-		Cast<AEnemy>(OtherActor)->TakeDamage(Damage);
-		Explode();
-	}
+	const FActorCategories* Categories = ActorCategories->Find(OtherActor);
+	if (Categories == nullptr)
+		return false;
+
+	if (Categories->Player)
+		return true;
+
+	return Categories->Enemy && OtherActor != OwnerActor.Get();
 }
 
-void AProjectile::Explode()
+void AProjectile::Impact(AActor* HitActor)
 {
-	if (ExplosionVfx != nullptr)
+	if (!bLaunched)
+		return;
+
+	if (const FActorCategories* Categories = ActorCategories->Find(HitActor))
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), ExplosionVfx, GetActorLocation(), GetActorRotation());
+		if (Categories->Player)
+			Categories->Player->TakeDamage(Damage);
+		else if (Categories->Enemy)
+			Categories->Enemy->TakeDamage(Damage);
 	}
 
-	SoundManager::PlayRandomSoundAtLocation(GetWorld(), ImpactSfx, GetActorLocation(), SoundAttenuation);
-
-	if (ProjectileVisuals != nullptr)
-		ProjectileVisuals->Destroy();
-
-	Destroy();
+	Explode();
 }
 
-void AProjectile::Move(float DeltaTime)
+void AProjectile::Explode()
 {
-	if (FVector::Distance(GetActorLocation(), Target) < Speed * DeltaTime)
+	if (ExplosionVfx != nullptr)
 	{
-		Explode();
+		GetWorld()->GetSubsystem<UVfxSubsystem>()->SpawnSystemAtLocation(ExplosionVfx, GetActorLocation(), GetActorRotation());
 	}
 
-	SetActorLocation(GetActorLocation() + (Target - GetActorLocation()).GetSafeNormal() * Speed * DeltaTime);
-}
+	GetWorld()->GetSubsystem<USoundManager>()->PlayRandomSoundAtLocation(ImpactSfx, GetActorLocation(), SoundAttenuation);
+
+	DEC_DWORD_STAT(STAT_VenariLiveProjectiles);
+	bLaunched = false;
+	GetWorld()->GetSubsystem<UProjectileSubsystem>()->RemoveProjectile(this);
+
+	// Not pooled actors are destroyed by the pool
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (ProjectileVisuals.IsValid())
+		Pool->Release(ProjectileVisuals.Get());
 
+	Pool->Release(this);
+}
\ No newline at end of file
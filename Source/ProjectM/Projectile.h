@@ -4,10 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "PoolableInterface.h"
 #include "Projectile.generated.h"
 
 UCLASS()
-class PROJECTM_API AProjectile : public AActor
+class PROJECTM_API AProjectile : public AActor, public IPoolableInterface
 {
 	GENERATED_BODY()
 	
@@ -15,24 +16,29 @@ public:
 	// Sets default values for this actor's properties
 	AProjectile();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 		class UStaticMeshComponent* Mesh;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 		class USphereComponent* Trigger;
 
-	virtual void Launch(FVector Target, AActor* VisualsRef = nullptr, AActor* Owner = nullptr);
+	virtual void Launch(FVector Target, AActor* VisualsRef = nullptr, AActor* Owner = nullptr); // Arms the projectile, taking ownership of the visuals
+
+	bool CanHit(const AActor* OtherActor) const; // Players and enemies other than the owner
+	void Impact(AActor* HitActor); // Damage the hit actor, if any, and explode
+
+	// IPoolableInterface
+	virtual void OnAcquiredFromPoolCPP() override;
+	virtual void OnReleasedToPoolCPP() override; // Drops the visuals and owner references
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:	
-	UFUNCTION()
-		virtual void OnBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	friend class UProjectileSubsystem;
+	int32 SimulationIndex = INDEX_NONE; // Index of the projectile's flight state in the projectile subsystem
 
 	UPROPERTY(EditAnywhere)
 		float Speed = 100.0f;
@@ -45,12 +51,14 @@ private:
 
 	UPROPERTY(EditAnywhere)
 		class UNiagaraSystem* ExplosionVfx;
+	UPROPERTY(EditAnywhere)
+		int32 ExplosionVfxPrewarmCount = 4; // Explosions added to the effect pool when the first projectile spawns
 
-	void Explode();
+	void Explode(); // Returns the projectile and its visuals to the pool
 
-	AActor* ProjectileVisuals;
+	bool bLaunched = false; // Moved by the projectile subsystem from launch until it explodes
 
-	void Move(float DeltaTime);
+	TWeakObjectPtr<AActor> ProjectileVisuals;
 
 	FVector Target;
 
@@ -60,5 +68,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 		class USoundAttenuation* SoundAttenuation;
 
-	AActor* OwnerActor;
+	TWeakObjectPtr<AActor> OwnerActor;
+
+	class UActorCategorySubsystem* ActorCategories = nullptr; // Category bitmasks of the world's actors
 };
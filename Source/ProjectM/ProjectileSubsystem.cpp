@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileSubsystem.h"
+#include "ProjectM.h"
+#include "Projectile.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile simulation"), STAT_VenariProjectileSimulation, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated projectiles"), STAT_VenariSimulatedProjectiles, STATGROUP_Venari);
+
+void UProjectileSubsystem::Deinitialize()
+{
+	for (AProjectile* Projectile : Projectiles)
+	{
+		if (Projectile)
+			Projectile->SimulationIndex = INDEX_NONE;
+	}
+
+	Projectiles.Reset();
+	Positions.Reset();
+	Targets.Reset();
+	Speeds.Reset();
+	Radii.Reset();
+	Impacts.Reset();
+
+	Super::Deinitialize();
+}
+
+ETickableTickType UProjectileSubsystem::GetTickableTickType() const
+{
+	// Never tick the class default object
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileSubsystem::IsSimulated(const AProjectile* Projectile) const
+{
+	return Projectile && Projectiles.IsValidIndex(Projectile->SimulationIndex) && Projectiles[Projectile->SimulationIndex] == Projectile;
+}
+
+void UProjectileSubsystem::AddProjectile(AProjectile* Projectile, const FVector& Target, float Speed, float Radius)
+{
+	if (!Projectile)
+		return;
+
+	// Relaunching a projectile in flight only changes where it's going
+	if (IsSimulated(Projectile))
+	{
+		Targets[Projectile->SimulationIndex] = Target;
+		Speeds[Projectile->SimulationIndex] = Speed;
+		Radii[Projectile->SimulationIndex] = Radius;
+		return;
+	}
+
+	Projectile->SimulationIndex = Projectiles.Add(Projectile);
+	Positions.Add(Projectile->GetActorLocation());
+	Targets.Add(Target);
+	Speeds.Add(Speed);
+	Radii.Add(Radius);
+}
+
+// Swap remove the projectile's state, fixing up the index of the projectile moved into its place
+void UProjectileSubsystem::RemoveProjectile(AProjectile* Projectile)
+{
+	if (!IsSimulated(Projectile))
+		return;
+
+	const int32 Index = Projectile->SimulationIndex;
+	Projectiles.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Targets.RemoveAtSwap(Index, 1, false);
+	Speeds.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+
+	if (Projectiles.IsValidIndex(Index))
+		Projectiles[Index]->SimulationIndex = Index;
+
+	Projectile->SimulationIndex = INDEX_NONE;
+}
+
+// Integrate and sweep every projectile, then push transforms and resolve impacts
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VenariProjectileSimulation);
+
+	const int32 NumProjectiles = Projectiles.Num();
+	SET_DWORD_STAT(STAT_VenariSimulatedProjectiles, NumProjectiles);
+
+	if (NumProjectiles == 0)
+		return;
+
+	UWorld* World = GetWorld();
+	const FCollisionObjectQueryParams ObjectParams(ECC_Pawn);
+
+	for (int32 Index = 0; Index < NumProjectiles; Index++)
+	{
+		const FVector Start = Positions[Index];
+		const FVector ToTarget = Targets[Index] - Start;
+		const float Distance = ToTarget.Size();
+		const float Step = Speeds[Index] * DeltaTime;
+
+		// Land exactly on the target instead of overshooting it
+		const bool bArrived = Distance <= Step;
+		FVector End = bArrived ? Targets[Index] : Start + ToTarget * (Step / Distance);
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(ProjectileSweep), false, Projectiles[Index]);
+		SweepHits.Reset();
+		World->SweepMultiByObjectType(SweepHits, Start, End, FQuat::Identity, ObjectParams,
+			FCollisionShape::MakeSphere(Radii[Index]), Params);
+
+		// Hits are sorted along the segment, the first one the projectile can damage stops it
+		AActor* HitActor = nullptr;
+		for (const FHitResult& Hit : SweepHits)
+		{
+			if (Projectiles[Index]->CanHit(Hit.GetActor()))
+			{
+				HitActor = Hit.GetActor();
+				End = Hit.Location;
+				break;
+			}
+		}
+
+		Positions[Index] = End;
+
+		if (HitActor || bArrived)
+			Impacts.Add({ Projectiles[Index], HitActor });
+	}
+
+	for (int32 Index = 0; Index < NumProjectiles; Index++)
+		Projectiles[Index]->SetActorLocation(Positions[Index]);
+
+	// Impacts remove projectiles from the arrays, so they're only resolved once the pass is over
+	for (const FProjectileImpact& Impact : Impacts)
+		Impact.Projectile->Impact(Impact.HitActor);
+
+	Impacts.Reset();
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileSubsystem.generated.h"
+
+class AProjectile;
+
+/**
+ * Moves every projectile in flight in a single pass, instead of one actor tick each.
+ * Each projectile sweeps a sphere along its segment every frame, so fast projectiles can't tunnel through pawns,
+ * and its transform is pushed to the actor once the whole pass is done.
+ */
+UCLASS()
+class PROJECTM_API UProjectileSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	// Start moving the projectile from its current location towards the target
+	void AddProjectile(AProjectile* Projectile, const FVector& Target, float Speed, float Radius);
+	void RemoveProjectile(AProjectile* Projectile);
+
+	int32 GetNumProjectiles() const { return Projectiles.Num(); }
+
+private:
+	bool IsSimulated(const AProjectile* Projectile) const;
+
+	UPROPERTY()
+		TArray<AProjectile*> Projectiles; // Dense, a projectile's index is stored in it and fixed up on removal
+
+	// Flight state, one entry per projectile
+	TArray<FVector> Positions;
+	TArray<FVector> Targets;
+	TArray<float> Speeds;
+	TArray<float> Radii;
+
+	// Projectiles that hit something or reached their target this frame, resolved after the pass
+	struct FProjectileImpact
+	{
+		AProjectile* Projectile;
+		AActor* HitActor; // Null if the projectile reached its target
+	};
+	TArray<FProjectileImpact> Impacts;
+	TArray<FHitResult> SweepHits; // Scratch for the sweeps, reused every projectile
+};
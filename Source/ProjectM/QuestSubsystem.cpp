@@ -0,0 +1,283 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSubsystem.h"
+#include "VenariGameInstance.h"
+#include "SaveSubsystem.h"
+#include "GameDataSubsystem.h"
+
+void UQuestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency(UGameDataSubsystem::StaticClass());
+	GameData = GetGameInstance()->GetSubsystem<UGameDataSubsystem>();
+	GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+
+	CompileQuests();
+
+	// Monsters defeated before the subsystem existed count once
+	if (GameInstance)
+	{
+		for (const FString& Monster : GameInstance->DefeatedMonsters)
+			KillCounts.FindOrAdd(FName(*Monster), 1);
+	}
+}
+
+void UQuestSubsystem::Deinitialize()
+{
+	Quests.Reset();
+	Nodes.Reset();
+	NodeProgress.Reset();
+	Subscribers.Reset();
+	KillCounts.Reset();
+	GameData = nullptr;
+	GameInstance = nullptr;
+
+	Super::Deinitialize();
+}
+
+// Flatten every quest's objectives into nodes
+void UQuestSubsystem::CompileQuests()
+{
+	for (int32 Id = 0; Id < GameData->GetQuests().Num(); Id++)
+	{
+		const TArrayView<const FQuestObjective> Objectives = GameData->GetQuestObjectives(Id);
+
+		FCompiledQuest& Quest = Quests.AddDefaulted_GetRef();
+		Quest.Row = GameData->GetQuest(Id)->Row;
+		Quest.FirstNode = Nodes.Num();
+		Quest.NumNodes = Objectives.Num();
+
+		for (const FQuestObjective& Objective : Objectives)
+		{
+			FObjectiveNode& Node = Nodes.AddDefaulted_GetRef();
+			Node.Key = { Objective.Type, Objective.Target };
+			Node.Required = FMath::Max(Objective.Count, 1);
+			Node.Quest = Id;
+		}
+	}
+
+	NodeProgress.SetNumZeroed(Nodes.Num());
+}
+
+bool UQuestSubsystem::StartQuest(FName QuestName)
+{
+	const int32 Quest = GameData->FindQuestId(QuestName);
+	if (Quest == INDEX_NONE || Quests[Quest].bActive || Quests[Quest].bCompleted)
+		return false;
+
+	for (int32 Node = Quests[Quest].FirstNode; Node < Quests[Quest].FirstNode + Quests[Quest].NumNodes; Node++)
+		NodeProgress[Node] = 0;
+
+	ActivateQuest(Quest);
+
+	if (GameInstance)
+		GameData->MakeQuestInfo(Quest, GameInstance->CurrentQuest);
+
+	return true;
+}
+
+void UQuestSubsystem::ActivateQuest(int32 Quest)
+{
+	FCompiledQuest& Compiled = Quests[Quest];
+	Compiled.bActive = true;
+
+	for (int32 Node = Compiled.FirstNode; Node < Compiled.FirstNode + Compiled.NumNodes; Node++)
+	{
+		if (NodeProgress[Node] < Nodes[Node].Required)
+			Subscribers.FindOrAdd(Nodes[Node].Key).Add(Node);
+	}
+
+	// Quests without objectives are completed by blueprints through CompleteQuest
+	if (Compiled.NumNodes > 0 && AreObjectivesDone(Quest))
+		MarkQuestCompleted(Quest);
+}
+
+// Only the objectives subscribed to the event are updated
+void UQuestSubsystem::RecordEvent(EQuestEventType Type, FName Target, int32 Amount)
+{
+	if (Target.IsNone() || Amount <= 0)
+		return;
+
+	if (Type == EQuestEventType::KILL)
+	{
+		int32& Kills = KillCounts.FindOrAdd(Target, 0);
+		if (Kills == 0 && GameInstance)
+			GameInstance->DefeatedMonsters.AddUnique(Target.ToString());
+		Kills += Amount;
+	}
+
+	const TArray<int32>* Subscribed = Subscribers.Find({ Type, Target });
+	if (!Subscribed)
+		return;
+
+	NotifiedNodes = *Subscribed;
+	for (int32 Node : NotifiedNodes)
+	{
+		const FObjectiveNode& Objective = Nodes[Node];
+		const FCompiledQuest& Quest = Quests[Objective.Quest];
+		if (!Quest.bActive)
+			continue;
+
+		NodeProgress[Node] = FMath::Min(NodeProgress[Node] + Amount, Objective.Required);
+		OnObjectiveProgress.Broadcast(Quest.Row, Node - Quest.FirstNode, NodeProgress[Node]);
+
+		if (NodeProgress[Node] >= Objective.Required)
+		{
+			if (TArray<int32>* Waiting = Subscribers.Find(Objective.Key))
+				Waiting->RemoveSwap(Node);
+
+			if (AreObjectivesDone(Objective.Quest))
+				MarkQuestCompleted(Objective.Quest);
+		}
+	}
+}
+
+bool UQuestSubsystem::CompleteQuest(FName QuestName)
+{
+	const int32 Quest = GameData->FindQuestId(QuestName);
+	if (Quest == INDEX_NONE || Quests[Quest].bCompleted)
+		return false;
+
+	// Quests accepted by blueprints only set the game instance's current quest
+	if (!Quests[Quest].bActive && !IsQuestActive(QuestName))
+		return false;
+
+	MarkQuestCompleted(Quest);
+	return true;
+}
+
+void UQuestSubsystem::MarkQuestCompleted(int32 Quest)
+{
+	Unsubscribe(Quest);
+	Quests[Quest].bActive = false;
+	Quests[Quest].bCompleted = true;
+
+	OnQuestCompleted.Broadcast(Quests[Quest].Row);
+}
+
+void UQuestSubsystem::Unsubscribe(int32 Quest)
+{
+	const FCompiledQuest& Compiled = Quests[Quest];
+	for (int32 Node = Compiled.FirstNode; Node < Compiled.FirstNode + Compiled.NumNodes; Node++)
+	{
+		if (TArray<int32>* Waiting = Subscribers.Find(Nodes[Node].Key))
+			Waiting->RemoveSwap(Node);
+	}
+}
+
+bool UQuestSubsystem::AreObjectivesDone(int32 Quest) const
+{
+	const FCompiledQuest& Compiled = Quests[Quest];
+	for (int32 Node = Compiled.FirstNode; Node < Compiled.FirstNode + Compiled.NumNodes; Node++)
+	{
+		if (NodeProgress[Node] < Nodes[Node].Required)
+			return false;
+	}
+
+	return true;
+}
+
+const UQuestSubsystem::FCompiledQuest* UQuestSubsystem::FindQuest(FName Quest) const
+{
+	const int32 Id = GameData->FindQuestId(Quest);
+	return Id != INDEX_NONE ? &Quests[Id] : nullptr;
+}
+
+bool UQuestSubsystem::IsQuestActive(FName Quest) const
+{
+	const FCompiledQuest* Compiled = FindQuest(Quest);
+	if (Compiled && Compiled->bActive)
+		return true;
+
+	// Quests accepted by blueprints that only set the current quest
+	return GameInstance && !GameInstance->CurrentQuest.Name.IsEmpty() && Quest == FName(*GameInstance->CurrentQuest.Name);
+}
+
+bool UQuestSubsystem::IsQuestCompleted(FName Quest) const
+{
+	const FCompiledQuest* Compiled = FindQuest(Quest);
+	return Compiled && Compiled->bCompleted;
+}
+
+int32 UQuestSubsystem::GetKillCount(FName Monster) const
+{
+	const int32* Kills = KillCounts.Find(Monster);
+	return Kills ? *Kills : 0;
+}
+
+// Active quests save the progress of each of their objectives, prefixed by how many there are
+void UQuestSubsystem::ExportProgress(FVenariSaveData& OutData) const
+{
+	for (const TPair<FName, int32>& Kills : KillCounts)
+	{
+		OutData.KilledMonsters.Add(Kills.Key);
+		OutData.KillCounts.Add(Kills.Value);
+	}
+
+	for (const FCompiledQuest& Quest : Quests)
+	{
+		if (Quest.bCompleted)
+		{
+			OutData.CompletedQuests.Add(Quest.Row);
+			continue;
+		}
+
+		if (!Quest.bActive)
+			continue;
+
+		OutData.ActiveQuests.Add(Quest.Row);
+		OutData.ActiveQuestProgress.Add(Quest.NumNodes);
+		OutData.ActiveQuestProgress.Append(&NodeProgress[Quest.FirstNode], Quest.NumNodes);
+	}
+}
+
+void UQuestSubsystem::ImportProgress(const FVenariSaveData& Data)
+{
+	KillCounts.Reset();
+	for (int32 i = 0; i < Data.KilledMonsters.Num() && i < Data.KillCounts.Num(); i++)
+		KillCounts.Add(Data.KilledMonsters[i], Data.KillCounts[i]);
+
+	// Saves without kill counters count every defeated monster once
+	for (const FString& Monster : Data.DefeatedMonsters)
+		KillCounts.FindOrAdd(FName(*Monster), 1);
+
+	Subscribers.Reset();
+	for (int32 Node = 0; Node < NodeProgress.Num(); Node++)
+		NodeProgress[Node] = 0;
+	for (FCompiledQuest& Quest : Quests)
+	{
+		Quest.bActive = false;
+		Quest.bCompleted = false;
+	}
+
+	for (FName Row : Data.CompletedQuests)
+	{
+		const int32 Quest = GameData->FindQuestId(Row);
+		if (Quest != INDEX_NONE)
+			Quests[Quest].bCompleted = true;
+	}
+
+	int32 Read = 0;
+	for (FName Row : Data.ActiveQuests)
+	{
+		if (!Data.ActiveQuestProgress.IsValidIndex(Read))
+			break;
+
+		const int32 NumSaved = Data.ActiveQuestProgress[Read++];
+		const int32 Quest = GameData->FindQuestId(Row);
+
+		// Progress is dropped if the quest's objectives changed since it was saved
+		if (Quest != INDEX_NONE && Quests[Quest].NumNodes == NumSaved && Read + NumSaved <= Data.ActiveQuestProgress.Num())
+		{
+			for (int32 i = 0; i < NumSaved; i++)
+				NodeProgress[Quests[Quest].FirstNode + i] = Data.ActiveQuestProgress[Read + i];
+		}
+
+		Read += FMath::Max(NumSaved, 0);
+
+		if (Quest != INDEX_NONE && !Quests[Quest].bCompleted)
+			ActivateQuest(Quest);
+	}
+}
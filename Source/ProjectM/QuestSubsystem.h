@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MyEnums.h"
+#include "QuestSubsystem.generated.h"
+
+class UGameDataSubsystem;
+struct FVenariSaveData;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FQuestObjectiveProgressSignature, FName, Quest, int32, Objective, int32, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FQuestCompletedSignature, FName, Quest);
+
+/**
+ * Quests and kill tracking.
+ * Quests of the game data are compiled once into flat objective nodes, the nodes of active quests
+ * subscribe to their event type and target, so an event only updates the objectives waiting for it.
+ * Kills are counted per monster name, the game instance's defeated monsters are kept up to date for the widgets.
+ */
+UCLASS()
+class PROJECTM_API UQuestSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Quest")
+		bool StartQuest(FName Quest); // Activate the quest by row or quest name, it becomes the game instance's current quest
+	UFUNCTION(BlueprintCallable, Category = "Quest")
+		void RecordEvent(EQuestEventType Type, FName Target, int32 Amount = 1);
+	UFUNCTION(BlueprintCallable, Category = "Quest")
+		bool CompleteQuest(FName Quest); // Quest row or quest name, for quests without objectives, fails if not active
+
+	UFUNCTION(BlueprintPure, Category = "Quest")
+		bool IsQuestActive(FName Quest) const; // Quest row or quest name, also true for the game instance's current quest
+	UFUNCTION(BlueprintPure, Category = "Quest")
+		bool IsQuestCompleted(FName Quest) const; // Quest row or quest name
+	UFUNCTION(BlueprintPure, Category = "Quest")
+		int32 GetKillCount(FName Monster) const;
+	UFUNCTION(BlueprintPure, Category = "Quest")
+		bool HasKilledMonster(FName Monster) const { return GetKillCount(Monster) > 0; }
+
+	UPROPERTY(BlueprintAssignable, Category = "Quest")
+		FQuestObjectiveProgressSignature OnObjectiveProgress;
+	UPROPERTY(BlueprintAssignable, Category = "Quest")
+		FQuestCompletedSignature OnQuestCompleted;
+
+	void ExportProgress(FVenariSaveData& OutData) const;
+	void ImportProgress(const FVenariSaveData& Data);
+
+private:
+	struct FQuestEventKey
+	{
+		EQuestEventType Type;
+		FName Target;
+
+		bool operator==(const FQuestEventKey& Other) const { return Type == Other.Type && Target == Other.Target; }
+		friend uint32 GetTypeHash(const FQuestEventKey& Key) { return HashCombine(GetTypeHash((uint8)Key.Type), GetTypeHash(Key.Target)); }
+	};
+
+	struct FCompiledQuest // Same indexing as the game data's quests
+	{
+		FName Row;
+		int32 FirstNode = 0; // Objective nodes of the quest are contiguous
+		int32 NumNodes = 0;
+		bool bActive = false;
+		bool bCompleted = false;
+	};
+
+	struct FObjectiveNode
+	{
+		FQuestEventKey Key;
+		int32 Required = 1;
+		int32 Quest = INDEX_NONE;
+	};
+
+	class UVenariGameInstance* GameInstance = nullptr;
+
+	UPROPERTY()
+		UGameDataSubsystem* GameData;
+
+	TArray<FCompiledQuest> Quests;
+	TArray<FObjectiveNode> Nodes;
+	TArray<int32> NodeProgress; // Same indexing as Nodes
+
+	TMap<FQuestEventKey, TArray<int32>> Subscribers; // Objective nodes of active quests waiting for each event
+	TArray<int32> NotifiedNodes; // Copy of the subscribers being updated, quests unsubscribe when they complete
+
+	TMap<FName, int32> KillCounts;
+
+	void CompileQuests();
+	void ActivateQuest(int32 Quest); // Subscribe its unfinished objectives
+	void MarkQuestCompleted(int32 Quest);
+	void Unsubscribe(int32 Quest);
+	bool AreObjectivesDone(int32 Quest) const;
+	const FCompiledQuest* FindQuest(FName Quest) const;
+};
@@ -0,0 +1,433 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveSubsystem.h"
+#include "VenariGameInstance.h"
+#include "InventorySubsystem.h"
+#include "QuestSubsystem.h"
+#include "GameDataSubsystem.h"
+#include "Engine/Texture2D.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarSaveCompression(
+	TEXT("Venari.SaveCompression"),
+	1,
+	TEXT("Compress save files with zlib. 0: off, 1: on"),
+	ECVF_Default);
+
+namespace VenariSave
+{
+	constexpr uint32 MakeTag(char A, char B, char C, char D)
+	{
+		return (uint32)A | ((uint32)B << 8) | ((uint32)C << 16) | ((uint32)D << 24);
+	}
+
+	constexpr uint32 Magic = MakeTag('V', 'S', 'A', 'V');
+	constexpr uint32 CompressedFlag = 1 << 0;
+	constexpr int32 MaxPayloadSize = 64 * 1024 * 1024; // Rejects corrupted headers before allocating
+
+	// Chunks
+	constexpr uint32 InventoryTag = MakeTag('I', 'N', 'V', 'T');
+	constexpr uint32 QuestTag = MakeTag('Q', 'U', 'S', 'T');
+	constexpr uint32 MonstersTag = MakeTag('M', 'N', 'S', 'T');
+	constexpr uint32 CharacterTag = MakeTag('C', 'H', 'A', 'R');
+	constexpr uint32 LevelsTag = MakeTag('L', 'V', 'L', 'S');
+	constexpr uint32 KillsTag = MakeTag('K', 'I', 'L', 'L');
+	constexpr uint32 QuestProgressTag = MakeTag('Q', 'P', 'R', 'G');
+}
+
+FArchive& operator<<(FArchive& Ar, FVenariSaveData::FSavedItem& Item)
+{
+	return Ar << Item.Name << Item.Quantity;
+}
+
+// Same code path writes and reads every chunk
+void FVenariSaveData::Serialize(FArchive& Ar)
+{
+	TMap<uint32, TArray<uint8>> Chunks;
+	if (Ar.IsLoading())
+	{
+		while (!Ar.AtEnd() && !Ar.IsError())
+		{
+			uint32 Tag = 0;
+			TArray<uint8> Bytes;
+			Ar << Tag << Bytes;
+			Chunks.Add(Tag, MoveTemp(Bytes));
+		}
+	}
+
+	auto SerializeChunk = [&Ar, &Chunks](uint32 Tag, TFunctionRef<void(FArchive&)> Body)
+	{
+		if (Ar.IsSaving())
+		{
+			TArray<uint8> Bytes;
+			FMemoryWriter Writer(Bytes);
+			Body(Writer);
+			Ar << Tag << Bytes;
+			return;
+		}
+
+		// Missing chunks keep their defaults
+		if (TArray<uint8>* Bytes = Chunks.Find(Tag))
+		{
+			FMemoryReader Reader(*Bytes);
+			Body(Reader);
+			if (Reader.IsError())
+				Ar.SetError();
+		}
+	};
+
+	SerializeChunk(VenariSave::InventoryTag, [this](FArchive& Chunk) { Chunk << Inventory << EquippedItemIndex; });
+	SerializeChunk(VenariSave::QuestTag, [this](FArchive& Chunk) { Chunk << QuestName << QuestDescription << QuestIcon; });
+	SerializeChunk(VenariSave::MonstersTag, [this](FArchive& Chunk) { Chunk << DefeatedMonsters; });
+	SerializeChunk(VenariSave::CharacterTag, [this](FArchive& Chunk) { Chunk << CurrentCharacter; });
+	SerializeChunk(VenariSave::LevelsTag, [this](FArchive& Chunk) { Chunk << UnlockedLevels; });
+	SerializeChunk(VenariSave::KillsTag, [this](FArchive& Chunk) { Chunk << KilledMonsters << KillCounts; });
+	SerializeChunk(VenariSave::QuestProgressTag, [this](FArchive& Chunk) { Chunk << ActiveQuests << ActiveQuestProgress << CompletedQuests; });
+}
+
+bool FVenariSaveData::operator==(const FVenariSaveData& Other) const
+{
+	if (Inventory.Num() != Other.Inventory.Num())
+		return false;
+
+	for (int32 i = 0; i < Inventory.Num(); i++)
+	{
+		if (Inventory[i].Name != Other.Inventory[i].Name || Inventory[i].Quantity != Other.Inventory[i].Quantity)
+			return false;
+	}
+
+	return EquippedItemIndex == Other.EquippedItemIndex &&
+		QuestName == Other.QuestName && QuestDescription == Other.QuestDescription && QuestIcon == Other.QuestIcon &&
+		DefeatedMonsters == Other.DefeatedMonsters &&
+		CurrentCharacter == Other.CurrentCharacter &&
+		UnlockedLevels == Other.UnlockedLevels &&
+		KilledMonsters == Other.KilledMonsters && KillCounts == Other.KillCounts &&
+		ActiveQuests == Other.ActiveQuests && ActiveQuestProgress == Other.ActiveQuestProgress && CompletedQuests == Other.CompletedQuests;
+}
+
+// Header: magic, version, flags, payload size and checksum, followed by the payload
+void USaveSubsystem::WriteSaveFile(FVenariSaveData& Data, bool bCompress, TArray<uint8>& OutBytes)
+{
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	Data.Serialize(PayloadWriter);
+
+	uint32 Magic = VenariSave::Magic;
+	int32 Version = SaveVersion;
+	uint32 Flags = 0;
+	int32 PayloadSize = Payload.Num();
+	uint32 Checksum = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+
+		if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()))
+		{
+			Compressed.SetNum(CompressedSize, false);
+			Payload = MoveTemp(Compressed);
+			Flags |= VenariSave::CompressedFlag;
+		}
+	}
+
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+	Writer << Magic << Version << Flags << PayloadSize << Checksum;
+	Writer.Serialize(Payload.GetData(), Payload.Num());
+}
+
+bool USaveSubsystem::ReadSaveFile(const TArray<uint8>& Bytes, FVenariSaveData& OutData)
+{
+	FMemoryReader Reader(Bytes);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 Flags = 0;
+	int32 PayloadSize = 0;
+	uint32 Checksum = 0;
+	Reader << Magic << Version << Flags << PayloadSize << Checksum;
+
+	if (Reader.IsError() || Magic != VenariSave::Magic || Version <= 0 || Version > SaveVersion ||
+		PayloadSize < 0 || PayloadSize > VenariSave::MaxPayloadSize)
+		return false;
+
+	const uint8* Stored = Bytes.GetData() + Reader.Tell();
+	const int32 StoredSize = Bytes.Num() - (int32)Reader.Tell();
+
+	TArray<uint8> Payload;
+	if (Flags & VenariSave::CompressedFlag)
+	{
+		Payload.SetNumUninitialized(PayloadSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Payload.GetData(), PayloadSize, Stored, StoredSize))
+			return false;
+	}
+	else
+	{
+		if (StoredSize != PayloadSize)
+			return false;
+		Payload.Append(Stored, StoredSize);
+	}
+
+	if (FCrc::MemCrc32(Payload.GetData(), Payload.Num()) != Checksum)
+		return false;
+
+	FMemoryReader PayloadReader(Payload);
+	OutData.Serialize(PayloadReader);
+	return !PayloadReader.IsError();
+}
+
+void USaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Loading rebuilds the inventory, the quests and the level unlocks
+	Collection.InitializeDependency(UGameDataSubsystem::StaticClass());
+	Collection.InitializeDependency(UInventorySubsystem::StaticClass());
+	Collection.InitializeDependency(UQuestSubsystem::StaticClass());
+	GameData = GetGameInstance()->GetSubsystem<UGameDataSubsystem>();
+
+	SavePath = FPaths::ProjectSavedDir() / TEXT("SaveGames") / TEXT("Venari.sav");
+	TempPath = SavePath + TEXT(".tmp");
+}
+
+void USaveSubsystem::Deinitialize()
+{
+	// Don't leave a save half written
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	Super::Deinitialize();
+}
+
+// Copy the progress on the game thread, everything else runs on a background task
+void USaveSubsystem::SaveProgress()
+{
+	if (bSaveInFlight)
+	{
+		bSaveQueued = true;
+		return;
+	}
+
+	FVenariSaveData Data;
+	GatherProgress(Data);
+
+	bSaveInFlight = true;
+	const bool bCompress = CVarSaveCompression.GetValueOnGameThread() != 0;
+	TWeakObjectPtr<USaveSubsystem> WeakThis(this);
+
+	SaveTask = Async(EAsyncExecution::ThreadPool, [Data = MoveTemp(Data), Path = SavePath, TempPath = TempPath, bCompress, WeakThis]() mutable
+	{
+		TArray<uint8> Bytes;
+		WriteSaveFile(Data, bCompress, Bytes);
+
+		// A crash mid write only loses the temporary file, the move deletes the old save before renaming
+		// so a crash during it can leave only the temporary file, which loading falls back to
+		const bool bSucceeded = FFileHelper::SaveArrayToFile(Bytes, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true, true);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bSucceeded]()
+		{
+			if (USaveSubsystem* SaveSubsystem = WeakThis.Get())
+				SaveSubsystem->OnSaveFinished(bSucceeded);
+		});
+
+		return bSucceeded;
+	});
+}
+
+void USaveSubsystem::OnSaveFinished(bool bSucceeded)
+{
+	bSaveInFlight = false;
+
+	if (!bSucceeded)
+		UE_LOG(LogTemp, Warning, TEXT("Save: failed to write %s"), *SavePath);
+
+	// Progress changed while saving
+	if (bSaveQueued)
+	{
+		bSaveQueued = false;
+		SaveProgress();
+	}
+}
+
+bool USaveSubsystem::LoadProgress()
+{
+	// Read the save once it's fully written
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	FVenariSaveData Data;
+	if (!LoadSaveFile(SavePath, Data))
+	{
+		if (!LoadSaveFile(TempPath, Data))
+			return false;
+
+		UE_LOG(LogTemp, Warning, TEXT("Save: loaded %s instead of %s"), *TempPath, *SavePath);
+	}
+
+	ApplyProgress(Data);
+	return true;
+}
+
+bool USaveSubsystem::LoadSaveFile(const FString& Path, FVenariSaveData& OutData)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+		return false;
+
+	if (!ReadSaveFile(Bytes, OutData))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Save: %s is corrupted or from a newer version"), *Path);
+		OutData = FVenariSaveData();
+		return false;
+	}
+
+	return true;
+}
+
+bool USaveSubsystem::HasSavedProgress() const
+{
+	return IFileManager::Get().FileExists(*SavePath) || IFileManager::Get().FileExists(*TempPath);
+}
+
+void USaveSubsystem::GatherProgress(FVenariSaveData& OutData) const
+{
+	UVenariGameInstance* GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+	if (!GameInstance)
+		return;
+
+	// Inventory slots, by item name
+	const UInventorySubsystem* Inventory = GameInstance->GetSubsystem<UInventorySubsystem>();
+	OutData.Inventory.SetNum(Inventory->GetNumSlots());
+	for (int32 Slot = 0; Slot < OutData.Inventory.Num(); Slot++)
+	{
+		if (const FItemStruct* Item = Inventory->GetSlotItem(Slot))
+		{
+			OutData.Inventory[Slot].Name = Item->Name;
+			OutData.Inventory[Slot].Quantity = Inventory->GetStack(Slot)->Quantity;
+		}
+	}
+	OutData.EquippedItemIndex = GameInstance->EquippedItemIndex;
+
+	OutData.QuestName = GameInstance->CurrentQuest.Name;
+	OutData.QuestDescription = GameInstance->CurrentQuest.Description;
+	OutData.QuestIcon = FSoftObjectPath(GameInstance->CurrentQuest.Icon).ToString();
+
+	OutData.DefeatedMonsters = GameInstance->DefeatedMonsters;
+	OutData.CurrentCharacter = (uint8)GameInstance->CurrentCharacter;
+
+	for (int32 Level = 0; Level < GameData->GetNumLevels(); Level++)
+	{
+		if (GameData->IsLevelUnlocked(Level))
+			OutData.UnlockedLevels.Add(GameData->GetLevel(Level)->Row);
+	}
+
+	GameInstance->GetSubsystem<UQuestSubsystem>()->ExportProgress(OutData);
+}
+
+void USaveSubsystem::ApplyProgress(const FVenariSaveData& Data)
+{
+	UVenariGameInstance* GameInstance = Cast<UVenariGameInstance>(GetGameInstance());
+	if (!GameInstance)
+		return;
+
+	// Inventory data is rebuilt from the static item data, then the inventory refills its slots from it
+	UInventorySubsystem* Inventory = GameInstance->GetSubsystem<UInventorySubsystem>();
+	GameInstance->InventoryData.SetNum(Data.Inventory.Num());
+	for (int32 Slot = 0; Slot < Data.Inventory.Num(); Slot++)
+	{
+		const FItemStruct* Item = Data.Inventory[Slot].Name.IsNone() ? nullptr : Inventory->FindItemData(Data.Inventory[Slot].Name);
+		GameInstance->InventoryData[Slot] = Item ? *Item : FItemStruct();
+		GameInstance->InventoryData[Slot].Quantity = Item ? Data.Inventory[Slot].Quantity : 0;
+	}
+	Inventory->ResetFromGameInstance();
+	GameInstance->EquippedItemIndex = Data.EquippedItemIndex;
+
+	GameInstance->CurrentQuest.Name = Data.QuestName;
+	GameInstance->CurrentQuest.Description = Data.QuestDescription;
+	GameInstance->CurrentQuest.Icon = Data.QuestIcon.IsEmpty() ? nullptr : Cast<UTexture2D>(FSoftObjectPath(Data.QuestIcon).TryLoad());
+
+	GameInstance->DefeatedMonsters = Data.DefeatedMonsters;
+	GameInstance->CurrentCharacter = (EPlayerCharacter)Data.CurrentCharacter;
+
+	for (int32 Level = 0; Level < GameData->GetNumLevels(); Level++)
+		GameData->SetLevelUnlocked(Level, false);
+	for (FName Row : Data.UnlockedLevels)
+		GameData->SetLevelUnlocked(GameData->FindLevelId(Row), true);
+
+	GameInstance->GetSubsystem<UQuestSubsystem>()->ImportProgress(Data);
+}
+
+#if !UE_BUILD_SHIPPING
+
+// Round trip and throughput of the save format
+// Usage: Venari.BenchSaveGame [Iterations] [InventorySlots] [DefeatedMonsters]
+static FAutoConsoleCommand BenchSaveGameCommand(
+	TEXT("Venari.BenchSaveGame"),
+	TEXT("Times writing and reading the save format, with and without compression. Args: [Iterations=1000] [InventorySlots=64] [DefeatedMonsters=64]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+		const int32 NumSlots = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 0) : 64;
+		const int32 NumMonsters = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 0) : 64;
+
+		FRandomStream Random(1234);
+		FVenariSaveData Data;
+		for (int32 i = 0; i < NumSlots; i++)
+			Data.Inventory.Add({ FName(*FString::Printf(TEXT("Item_%d"), Random.RandRange(0, 31))), Random.RandRange(1, 99) });
+		for (int32 i = 0; i < NumMonsters; i++)
+			Data.DefeatedMonsters.Add(FString::Printf(TEXT("Monster_%d"), i));
+		for (int32 i = 0; i < 16; i++)
+			Data.UnlockedLevels.Add(FName(*FString::Printf(TEXT("Level_%d"), i)));
+		Data.EquippedItemIndex = 3;
+		Data.QuestName = TEXT("Hunt the giant");
+		Data.QuestDescription = TEXT("Find the giant's lair and defeat it.");
+		Data.QuestIcon = TEXT("/Game/05_UI/Icons/T_Quest.T_Quest");
+		Data.CurrentCharacter = 1;
+		for (int32 i = 0; i < NumMonsters; i++)
+		{
+			Data.KilledMonsters.Add(FName(*Data.DefeatedMonsters[i]));
+			Data.KillCounts.Add(Random.RandRange(1, 20));
+		}
+		Data.ActiveQuests.Add(TEXT("Quest_Giant"));
+		Data.ActiveQuestProgress.Append({ 2, 1, 0 });
+		Data.CompletedQuests.Add(TEXT("Quest_Tutorial"));
+
+		for (const bool bCompress : { false, true })
+		{
+			TArray<uint8> Bytes;
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; i++)
+				USaveSubsystem::WriteSaveFile(Data, bCompress, Bytes);
+			const double WriteTime = FPlatformTime::Seconds() - StartTime;
+
+			FVenariSaveData Loaded;
+			bool bRoundTrip = true;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				Loaded = FVenariSaveData();
+				bRoundTrip &= USaveSubsystem::ReadSaveFile(Bytes, Loaded);
+			}
+			const double ReadTime = FPlatformTime::Seconds() - StartTime;
+			bRoundTrip &= Loaded == Data;
+
+			const double Megabytes = (double)Bytes.Num() * Iterations / (1024.0 * 1024.0);
+			UE_LOG(LogTemp, Display, TEXT("Save format%s, %d bytes x %d iterations: write %.3f ms (%.1f MB/s), read %.3f ms (%.1f MB/s), round trip %s."),
+				bCompress ? TEXT(" compressed") : TEXT(""), Bytes.Num(), Iterations,
+				WriteTime * 1000.0, WriteTime > 0.0 ? Megabytes / WriteTime : 0.0,
+				ReadTime * 1000.0, ReadTime > 0.0 ? Megabytes / ReadTime : 0.0,
+				bRoundTrip ? TEXT("ok") : TEXT("FAILED"));
+		}
+	}));
+
+#endif
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Async/Future.h"
+#include "SaveSubsystem.generated.h"
+
+// Plain copy of the game's progress, serialized without touching UObjects
+struct FVenariSaveData
+{
+	struct FSavedItem
+	{
+		FName Name; // None on empty slots
+		int32 Quantity = 0;
+	};
+
+	TArray<FSavedItem> Inventory; // Inventory slots, in order
+	int32 EquippedItemIndex = 0;
+
+	FString QuestName;
+	FString QuestDescription;
+	FString QuestIcon; // Soft path of the quest icon
+
+	TArray<FString> DefeatedMonsters;
+	uint8 CurrentCharacter = 0;
+	TArray<FName> UnlockedLevels; // Rows of the levels data table that are unlocked
+
+	TArray<FName> KilledMonsters;
+	TArray<int32> KillCounts; // Same indexing as KilledMonsters
+	TArray<FName> ActiveQuests; // Rows of the quest data table
+	TArray<int32> ActiveQuestProgress; // Per active quest, its number of objectives followed by their progress
+	TArray<FName> CompletedQuests;
+
+	void Serialize(FArchive& Ar); // Tagged chunks, unknown chunks are skipped and missing ones keep their defaults when loading
+	bool operator==(const FVenariSaveData& Other) const;
+};
+
+/**
+ * Saves the game instance's progress to a versioned binary file.
+ * Progress is copied on the game thread, serialized, compressed and written on a background task,
+ * the file is written to a temporary file first and moved over the save, loading falls back to the temporary file
+ * when a crash during the move left the save missing or the save is corrupted.
+ */
+UCLASS()
+class PROJECTM_API USaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Save")
+		void SaveProgress(); // Asynchronous, saves again once done if called while saving
+	UFUNCTION(BlueprintCallable, Category = "Save")
+		bool LoadProgress(); // Replaces the game instance's progress with the saved one
+	UFUNCTION(BlueprintPure, Category = "Save")
+		bool HasSavedProgress() const; // Either the save or the temporary file it was written to exists
+	UFUNCTION(BlueprintPure, Category = "Save")
+		bool IsSaving() const { return bSaveInFlight; }
+
+	static constexpr int32 SaveVersion = 1; // Increase when the layout of a chunk changes
+
+	// Serialized save file, header and optionally compressed chunks
+	static void WriteSaveFile(FVenariSaveData& Data, bool bCompress, TArray<uint8>& OutBytes);
+	static bool ReadSaveFile(const TArray<uint8>& Bytes, FVenariSaveData& OutData);
+
+private:
+	FString SavePath;
+	FString TempPath; // Written first, then moved over the save
+
+	bool bSaveInFlight = false;
+	bool bSaveQueued = false;
+	TFuture<bool> SaveTask;
+
+	UPROPERTY()
+		class UGameDataSubsystem* GameData;
+
+	static bool LoadSaveFile(const FString& Path, FVenariSaveData& OutData); // False if missing, corrupted or from a newer version
+
+	void GatherProgress(FVenariSaveData& OutData) const;
+	void ApplyProgress(const FVenariSaveData& Data);
+	void OnSaveFinished(bool bSucceeded); // Game thread
+};
@@ -2,62 +2,233 @@
 
 
 #include "SoundManager.h"
-#include "Kismet/GameplayStatics.h"
+#include "ProjectM.h"
+#include "Sound/SoundBase.h"
 #include "Sound/SoundAttenuation.h"
 #include "Components/AudioComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voices requested"), STAT_VenariVoicesRequested, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voices played"), STAT_VenariVoicesPlayed, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voices culled"), STAT_VenariVoicesCulled, STATGROUP_Venari);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active voices"), STAT_VenariActiveVoices, STATGROUP_Venari);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled audio components"), STAT_VenariPooledAudioComponents, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sound events queued"), STAT_VenariSoundEventsQueued, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sound events merged"), STAT_VenariSoundEventsMerged, STATGROUP_Venari);
+
+void USoundManager::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_VenariActiveVoices, ActiveVoices.Num());
+	DEC_DWORD_STAT_BY(STAT_VenariPooledAudioComponents, ActiveVoices.Num() + FreeComponents.Num());
+
+	for (const TPair<UAudioComponent*, uint32>& Voice : ActiveVoices)
+	{
+		if (IsValid(Voice.Key))
+			Voice.Key->DestroyComponent();
+	}
+
+	for (UAudioComponent* AudioComponent : FreeComponents)
+	{
+		if (IsValid(AudioComponent))
+			AudioComponent->DestroyComponent();
+	}
+
+	ActiveVoices.Reset();
+	FreeComponents.Reset();
+	BankVoiceCounts.Reset();
+	QueuedSounds.Reset();
+
+	Super::Deinitialize();
+}
 
-SoundManager::SoundManager()
+ETickableTickType USoundManager::GetTickableTickType() const
 {
+	// Never tick the class default object
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
 }
 
-SoundManager::~SoundManager()
+TStatId USoundManager::GetStatId() const
 {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USoundManager, STATGROUP_Tickables);
 }
 
-bool SoundManager::PlayRandomSoundAtLocation(const UObject* WorldObjectContext, TArray<class USoundBase*> Sounds, FVector Location, USoundAttenuation* AttenuationSettings)
+uint32 USoundManager::GetBankKey(TArrayView<USoundBase* const> Sounds)
 {
-	if (WorldObjectContext == nullptr)
-	{
-		return false;
-	}
+	uint32 Key = GetTypeHash(Sounds.Num());
+	for (USoundBase* Sound : Sounds)
+		Key = HashCombine(Key, GetTypeHash(Sound));
+
+	return Key;
+}
+
+UAudioComponent* USoundManager::AcquireVoice(TArrayView<USoundBase* const> Sounds, USoundAttenuation* AttenuationSettings, float VolumeMultiplier)
+{
+	INC_DWORD_STAT(STAT_VenariVoicesRequested);
 
 	if (Sounds.Num() <= 0)
+		return nullptr;
+
+	const uint32 Bank = GetBankKey(Sounds);
+	if (ActiveVoices.Num() >= MaxVoices || BankVoiceCounts.FindRef(Bank) >= MaxVoicesPerBank)
+		ReclaimStoppedVoices();
+
+	if (ActiveVoices.Num() >= MaxVoices || BankVoiceCounts.FindRef(Bank) >= MaxVoicesPerBank)
 	{
-		return false;
+		INC_DWORD_STAT(STAT_VenariVoicesCulled);
+		return nullptr;
 	}
 
 	int Index = FMath::RandRange(0, Sounds.Num() - 1);
-	if (AttenuationSettings != nullptr)
-		UGameplayStatics::SpawnSoundAtLocation(WorldObjectContext, Sounds[Index], Location, FRotator::ZeroRotator, 1.0f, 1.0f, 0.0f, AttenuationSettings);
-	else
-		UGameplayStatics::SpawnSoundAtLocation(WorldObjectContext, Sounds[Index], Location);
+	if (Sounds[Index] == nullptr)
+		return nullptr;
 
-	return true;
+	// Reuse a finished component, only create one when the pool is empty
+	UAudioComponent* AudioComponent = nullptr;
+	while (AudioComponent == nullptr && FreeComponents.Num() > 0)
+	{
+		AudioComponent = FreeComponents.Pop(false);
+		if (!IsValid(AudioComponent))
+		{
+			AudioComponent = nullptr;
+			DEC_DWORD_STAT(STAT_VenariPooledAudioComponents);
+		}
+	}
+
+	if (AudioComponent == nullptr)
+	{
+		AudioComponent = NewObject<UAudioComponent>(GetWorld()->GetWorldSettings());
+		AudioComponent->bAutoActivate = false;
+		AudioComponent->bAutoDestroy = false;
+		AudioComponent->bAllowSpatialization = true;
+		AudioComponent->RegisterComponentWithWorld(GetWorld());
+		AudioComponent->OnAudioFinishedNative.AddUObject(this, &USoundManager::OnVoiceFinished);
+		INC_DWORD_STAT(STAT_VenariPooledAudioComponents);
+	}
+
+	AudioComponent->SetSound(Sounds[Index]);
+	AudioComponent->AttenuationSettings = AttenuationSettings;
+	AudioComponent->SetVolumeMultiplier(VolumeMultiplier);
+
+	ActiveVoices.Add(AudioComponent, Bank);
+	BankVoiceCounts.FindOrAdd(Bank)++;
+	INC_DWORD_STAT(STAT_VenariActiveVoices);
+	INC_DWORD_STAT(STAT_VenariVoicesPlayed);
+	return AudioComponent;
 }
 
-bool SoundManager::PlayRandomSoundAttached(TArray<class USoundBase*> Sounds, USceneComponent* AttachToComponent, FName Socket, USoundAttenuation* AttenuationSettings)
+// Return the component to the pool and free its bank's voice
+void USoundManager::OnVoiceFinished(UAudioComponent* AudioComponent)
 {
-	if (AttachToComponent)
+	uint32 Bank;
+	if (!ActiveVoices.RemoveAndCopyValue(AudioComponent, Bank))
+		return;
+
+	// Banks without voices are forgotten, the map only holds playing banks
+	if (int32* BankVoices = BankVoiceCounts.Find(Bank))
 	{
-		return false;
+		if (--(*BankVoices) <= 0)
+			BankVoiceCounts.Remove(Bank);
 	}
+	DEC_DWORD_STAT(STAT_VenariActiveVoices);
 
-	if (Sounds.Num() <= 0)
+	// Components attached to destroyed actors can be destroyed with them
+	if (!IsValid(AudioComponent))
+	{
+		DEC_DWORD_STAT(STAT_VenariPooledAudioComponents);
+		return;
+	}
+
+	AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	FreeComponents.Add(AudioComponent);
+}
+
+void USoundManager::ReclaimStoppedVoices()
+{
+	TArray<UAudioComponent*, TInlineAllocator<MaxVoices>> Stopped;
+	for (const TPair<UAudioComponent*, uint32>& Voice : ActiveVoices)
 	{
+		if (!IsValid(Voice.Key) || !Voice.Key->IsPlaying())
+			Stopped.Add(Voice.Key);
+	}
+
+	for (UAudioComponent* AudioComponent : Stopped)
+		OnVoiceFinished(AudioComponent);
+}
+
+bool USoundManager::PlayRandomSoundAtLocation(TArrayView<USoundBase* const> Sounds, const FVector& Location, USoundAttenuation* AttenuationSettings, float VolumeMultiplier)
+{
+	UAudioComponent* AudioComponent = AcquireVoice(Sounds, AttenuationSettings, VolumeMultiplier);
+	if (AudioComponent == nullptr)
 		return false;
+
+	AudioComponent->SetWorldLocationAndRotation(Location, FRotator::ZeroRotator);
+	AudioComponent->Play();
+
+	return true;
+}
+
+void USoundManager::QueueRandomSoundAtLocation(TArrayView<USoundBase* const> Sounds, const FVector& Location, USoundAttenuation* AttenuationSettings)
+{
+	if (Sounds.Num() <= 0)
+		return;
+
+	INC_DWORD_STAT(STAT_VenariSoundEventsQueued);
+
+	const FIntVector Cell(FMath::FloorToInt(Location.X / MergeCellSize), FMath::FloorToInt(Location.Y / MergeCellSize),
+		FMath::FloorToInt(Location.Z / MergeCellSize));
+
+	const uint32 Bank = GetBankKey(Sounds);
+
+	// Only a handful of requests are queued per frame, a linear search is enough
+	for (FQueuedSound& Queued : QueuedSounds)
+	{
+		if (Queued.Bank == Bank && Queued.AttenuationSettings == AttenuationSettings && Queued.Cell == Cell)
+		{
+			Queued.LocationSum += Location;
+			Queued.Count++;
+			INC_DWORD_STAT(STAT_VenariSoundEventsMerged);
+			return;
+		}
 	}
 
-	int Index = FMath::RandRange(0, Sounds.Num() - 1);
+	FQueuedSound& Queued = QueuedSounds.AddDefaulted_GetRef();
+	Queued.Sounds.Append(Sounds.GetData(), Sounds.Num());
+	Queued.Bank = Bank;
+	Queued.AttenuationSettings = AttenuationSettings;
+	Queued.Cell = Cell;
+	Queued.LocationSum = Location;
+	Queued.Count = 1;
+}
+
+// Play the merged requests of the frame
+void USoundManager::Tick(float DeltaTime)
+{
+	for (const FQueuedSound& Queued : QueuedSounds)
+	{
+		const float Volume = FMath::Min(1.0f + MergedVolumeStep * (Queued.Count - 1), MaxMergedVolume);
+		PlayRandomSoundAtLocation(Queued.Sounds, Queued.LocationSum / Queued.Count, Queued.AttenuationSettings, Volume);
+	}
 
-	if (AttenuationSettings != nullptr)
-		UGameplayStatics::SpawnSoundAttached(Sounds[Index], AttachToComponent, Socket, FVector::ZeroVector, EAttachLocation::KeepRelativeOffset, false, 1.0f, 1.0f, 0.0f, AttenuationSettings);
-	else
-		UGameplayStatics::SpawnSoundAttached(Sounds[Index], AttachToComponent, Socket, FVector::ZeroVector, EAttachLocation::KeepRelativeOffset);
+	QueuedSounds.Reset();
+}
+
+bool USoundManager::PlayRandomSoundAttached(TArrayView<USoundBase* const> Sounds, USceneComponent* AttachToComponent, FName Socket, USoundAttenuation* AttenuationSettings)
+{
+	if (AttachToComponent == nullptr)
+		return false;
+
+	UAudioComponent* AudioComponent = AcquireVoice(Sounds, AttenuationSettings, 1.0f);
+	if (AudioComponent == nullptr)
+		return false;
+
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale, Socket);
+	AudioComponent->Play();
 
 	return true;
 }
 
-bool SoundManager::PlayRandomSoundAudioComponent(UAudioComponent* AudioComponent, TArray<class USoundBase*> Sounds)
+bool USoundManager::PlayRandomSoundAudioComponent(UAudioComponent* AudioComponent, TArrayView<USoundBase* const> Sounds)
 {
 	if (AudioComponent == nullptr)
 	{
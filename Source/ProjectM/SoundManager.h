@@ -3,17 +3,73 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SoundManager.generated.h"
+
+class USoundBase;
+class USoundAttenuation;
+class UAudioComponent;
 
 /**
- * 
+ * Plays random sounds from sound banks (arrays of sound variations) on pooled audio components.
+ * Voices are budgeted per bank and in total, requests over budget are culled.
+ * Queued sounds are merged per bank and area over the frame and played together at its end.
  */
-class PROJECTM_API SoundManager
+UCLASS()
+class PROJECTM_API USoundManager : public UWorldSubsystem, public FTickableGameObject
 {
+	GENERATED_BODY()
+
 public:
-	SoundManager();
-	~SoundManager();
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	bool PlayRandomSoundAtLocation(TArrayView<USoundBase* const> Sounds, const FVector& Location, USoundAttenuation* AttenuationSettings = nullptr, float VolumeMultiplier = 1.0f);
+	// Play at the end of the frame, merged with the other requests of the bank close to it into one louder voice
+	void QueueRandomSoundAtLocation(TArrayView<USoundBase* const> Sounds, const FVector& Location, USoundAttenuation* AttenuationSettings = nullptr);
+	bool PlayRandomSoundAttached(TArrayView<USoundBase* const> Sounds, class USceneComponent* AttachToComponent, FName Socket = NAME_None, USoundAttenuation* AttenuationSettings = nullptr);
+	static bool PlayRandomSoundAudioComponent(UAudioComponent* AudioComponent, TArrayView<USoundBase* const> Sounds);
+
+	int32 GetNumActiveVoices() const { return ActiveVoices.Num(); }
+
+private:
+	// Picks a sound and a pooled component for it, null if the bank is empty or over budget
+	UAudioComponent* AcquireVoice(TArrayView<USoundBase* const> Sounds, USoundAttenuation* AttenuationSettings, float VolumeMultiplier);
+	void OnVoiceFinished(UAudioComponent* AudioComponent);
+	void ReclaimStoppedVoices(); // Return voices that stopped without reporting it, like sounds culled on play
+
+	// Banks are identified by their sounds, actors of the same type share a bank even though each owns its array
+	static uint32 GetBankKey(TArrayView<USoundBase* const> Sounds);
+
+	static constexpr int32 MaxVoices = 32;
+	static constexpr int32 MaxVoicesPerBank = 4; // Hit heavy banks can't take over every voice
+
+	UPROPERTY()
+		TArray<UAudioComponent*> FreeComponents;
+
+	UPROPERTY()
+		TMap<UAudioComponent*, uint32> ActiveVoices; // Playing components and the key of the bank they play from
+	TMap<uint32, int32> BankVoiceCounts; // Banks with playing voices only
+
+	// Requests of a bank in a cell this frame, merged into a single voice
+	struct FQueuedSound
+	{
+		TArray<USoundBase*, TInlineAllocator<4>> Sounds; // Copy of the first request's bank, its owner can be destroyed before the flush
+		uint32 Bank; // Requests from every actor sharing the bank's sounds merge
+		USoundAttenuation* AttenuationSettings;
+		FIntVector Cell;
+		FVector LocationSum; // Merged voice plays at the average location
+		int32 Count;
+	};
+	TArray<FQueuedSound> QueuedSounds;
 
-	static bool PlayRandomSoundAtLocation(const UObject* WorldObjectContext, TArray<class USoundBase*> Sounds, FVector Location, class USoundAttenuation* AttenuationSettings = nullptr);
-	static bool PlayRandomSoundAttached(TArray<class USoundBase*> Sounds, class USceneComponent* AttachToComponent, FName Socket = "", class USoundAttenuation* AttenuationSettings = nullptr);
-	static bool PlayRandomSoundAudioComponent(class UAudioComponent* AudioComponent, TArray<class USoundBase*> Sounds);
+	static constexpr float MergeCellSize = 500.0f; // Requests of a bank in the same cell are merged
+	static constexpr float MergedVolumeStep = 0.2f; // Extra volume per merged request
+	static constexpr float MaxMergedVolume = 2.0f;
 };
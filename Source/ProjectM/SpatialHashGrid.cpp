@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpatialHashGrid.h"
+
+FSpatialHashGrid::FSpatialHashGrid(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+}
+
+FIntPoint FSpatialHashGrid::ToCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+}
+
+void FSpatialHashGrid::Add(int32 Id, const FVector& Location)
+{
+	// Make sure the id isn't bucketed twice
+	if (IdCells.Contains(Id))
+	{
+		Move(Id, Location);
+		return;
+	}
+
+	const FIntPoint Cell = ToCell(Location);
+	Cells.FindOrAdd(Cell).Add(Id);
+	IdCells.Add(Id, Cell);
+}
+
+void FSpatialHashGrid::Remove(int32 Id)
+{
+	FIntPoint Cell;
+	if (!IdCells.RemoveAndCopyValue(Id, Cell))
+		return;
+
+	TArray<int32>* Bucket = Cells.Find(Cell);
+	if (!Bucket)
+		return;
+
+	Bucket->RemoveSingleSwap(Id, false);
+
+	// Drop empty cells so queries don't walk stale buckets
+	if (Bucket->Num() <= 0)
+		Cells.Remove(Cell);
+}
+
+void FSpatialHashGrid::Move(int32 Id, const FVector& NewLocation)
+{
+	FIntPoint* CurrentCell = IdCells.Find(Id);
+	if (!CurrentCell)
+	{
+		Add(Id, NewLocation);
+		return;
+	}
+
+	// Most movement happens inside a cell, nothing to update then
+	const FIntPoint NewCell = ToCell(NewLocation);
+	if (NewCell == *CurrentCell)
+		return;
+
+	Remove(Id);
+	Cells.FindOrAdd(NewCell).Add(Id);
+	IdCells.Add(Id, NewCell);
+}
+
+void FSpatialHashGrid::Reset()
+{
+	Cells.Reset();
+	IdCells.Reset();
+}
+
+void FSpatialHashGrid::Query(const FVector& Center, float Radius, TArray<int32>& OutIds) const
+{
+	const FIntPoint MinCell = ToCell(Center - FVector(Radius, Radius, 0.0f));
+	const FIntPoint MaxCell = ToCell(Center + FVector(Radius, Radius, 0.0f));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const TArray<int32>* Bucket = Cells.Find(FIntPoint(X, Y));
+			if (Bucket)
+				OutIds.Append(*Bucket);
+		}
+	}
+}
+
+bool FSpatialHashGrid::Contains(int32 Id) const
+{
+	return IdCells.Contains(Id);
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform 2D grid (XY plane) bucketing integer ids by location.
+ * Ids are owned by the caller, the grid only stores which cell each id is in.
+ * Queries return every id in the cells touched by the query circle, callers do the exact distance test.
+ */
+class PROJECTM_API FSpatialHashGrid
+{
+public:
+	explicit FSpatialHashGrid(float InCellSize = 1000.0f);
+
+	void Add(int32 Id, const FVector& Location); // Insert id in the cell containing location
+	void Remove(int32 Id); // Remove id from its cell
+	void Move(int32 Id, const FVector& NewLocation); // Re-bucket id, does nothing if it stays in the same cell
+	void Reset();
+
+	void Query(const FVector& Center, float Radius, TArray<int32>& OutIds) const; // Append ids of all cells overlapping the circle
+
+	bool Contains(int32 Id) const;
+
+private:
+	FIntPoint ToCell(const FVector& Location) const;
+
+	float CellSize;
+	float InvCellSize;
+
+	TMap<FIntPoint, TArray<int32>> Cells; // Ids bucketed per cell
+	TMap<int32, FIntPoint> IdCells; // Cell each id is currently in
+};
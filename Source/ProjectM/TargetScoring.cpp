@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TargetScoring.h"
+#include "Math/VectorRegister.h"
+#include "HAL/IConsoleManager.h"
+
+void FTargetCandidates::Reset()
+{
+	X.Reset();
+	Y.Reset();
+	Z.Reset();
+	Actors.Reset();
+}
+
+void FTargetCandidates::Add(AActor* Actor, const FVector& Location)
+{
+	X.Add(Location.X);
+	Y.Add(Location.Y);
+	Z.Add(Location.Z);
+	Actors.Add(Actor);
+}
+
+// Dot product of forward with each normalized direction, zero length directions score 0 like FVector::Normalize
+// Every score goes through here so hysteresis compares values computed the same way
+static FORCEINLINE VectorRegister ScoreDirections(const VectorRegister& DirX, const VectorRegister& DirY, const VectorRegister& DirZ,
+	const VectorRegister& ForwardX, const VectorRegister& ForwardY, const VectorRegister& ForwardZ, VectorRegister& OutLengthSquared)
+{
+	OutLengthSquared = VectorMultiplyAdd(DirX, DirX, VectorMultiplyAdd(DirY, DirY, VectorMultiply(DirZ, DirZ)));
+	const VectorRegister Projection = VectorMultiplyAdd(DirX, ForwardX, VectorMultiplyAdd(DirY, ForwardY, VectorMultiply(DirZ, ForwardZ)));
+	return VectorMultiply(Projection, VectorReciprocalSqrtAccurate(VectorMax(OutLengthSquared, VectorSetFloat1(SMALL_NUMBER))));
+}
+
+// Single direction through the vector path, same result as its lane would get in a batch
+static float ScoreDirection(const FVector& Direction, const FVector& Forward, float& OutLengthSquared)
+{
+	VectorRegister LengthSquared;
+	const VectorRegister Dot = ScoreDirections(VectorSetFloat1(Direction.X), VectorSetFloat1(Direction.Y), VectorSetFloat1(Direction.Z),
+		VectorSetFloat1(Forward.X), VectorSetFloat1(Forward.Y), VectorSetFloat1(Forward.Z), LengthSquared);
+
+	float Result;
+	VectorStoreFloat1(Dot, &Result);
+	VectorStoreFloat1(LengthSquared, &OutLengthSquared);
+	return Result;
+}
+
+float FTargetScoring::ScoreLocation(const FVector& Location, const FVector& Origin, const FVector& Forward)
+{
+	float LengthSquared;
+	return ScoreDirection(Location - Origin, Forward, LengthSquared);
+}
+
+// Scores candidates in [Start, End) one at a time with the old scalar math, keeping the first candidate with the highest dot product
+static void ScoreCandidateRange(const float* X, const float* Y, const float* Z, int32 Start, int32 End,
+	const FVector& Origin, const FVector& Forward, float MaxDistanceSquared, int32& BestIndex, float& BestDot)
+{
+	for (int32 i = Start; i < End; i++)
+	{
+		const FVector Direction(X[i] - Origin.X, Y[i] - Origin.Y, Z[i] - Origin.Z);
+		if (Direction.SizeSquared() > MaxDistanceSquared)
+			continue;
+
+		const float DotProd = FVector::DotProduct(Forward, Direction.GetSafeNormal());
+		if (DotProd > BestDot)
+		{
+			BestIndex = i;
+			BestDot = DotProd;
+		}
+	}
+}
+
+int32 FTargetScoring::FindBestCandidateScalar(const float* X, const float* Y, const float* Z, int32 Num,
+	const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot)
+{
+	const float MaxDistanceSquared = MaxDistance > 0.0f ? MaxDistance * MaxDistance : BIG_NUMBER;
+
+	int32 BestIndex = INDEX_NONE;
+	OutDot = MinDot;
+	ScoreCandidateRange(X, Y, Z, 0, Num, Origin, Forward, MaxDistanceSquared, BestIndex, OutDot);
+
+	return BestIndex;
+}
+
+int32 FTargetScoring::FindBestCandidate(const float* X, const float* Y, const float* Z, int32 Num,
+	const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot)
+{
+	const float MaxDistanceSquared = MaxDistance > 0.0f ? MaxDistance * MaxDistance : BIG_NUMBER;
+
+	const VectorRegister OriginX = VectorSetFloat1(Origin.X);
+	const VectorRegister OriginY = VectorSetFloat1(Origin.Y);
+	const VectorRegister OriginZ = VectorSetFloat1(Origin.Z);
+	const VectorRegister ForwardX = VectorSetFloat1(Forward.X);
+	const VectorRegister ForwardY = VectorSetFloat1(Forward.Y);
+	const VectorRegister ForwardZ = VectorSetFloat1(Forward.Z);
+	const VectorRegister MaxDistanceSquaredV = VectorSetFloat1(MaxDistanceSquared);
+	const VectorRegister IndexStep = VectorSetFloat1(4.0f);
+
+	// Best dot product and index found by each lane
+	// Indices are stored as floats, exact for any realistic candidate count
+	VectorRegister BestDots = VectorSetFloat1(MinDot);
+	VectorRegister BestIndices = VectorSetFloat1(-1.0f);
+	VectorRegister Indices = MakeVectorRegister(0.0f, 1.0f, 2.0f, 3.0f);
+
+	const int32 NumVectorized = Num & ~3;
+	for (int32 i = 0; i < NumVectorized; i += 4)
+	{
+		// Direction from origin to each candidate
+		const VectorRegister DirX = VectorSubtract(VectorLoad(X + i), OriginX);
+		const VectorRegister DirY = VectorSubtract(VectorLoad(Y + i), OriginY);
+		const VectorRegister DirZ = VectorSubtract(VectorLoad(Z + i), OriginZ);
+
+		VectorRegister LengthSquared;
+		const VectorRegister Dots = ScoreDirections(DirX, DirY, DirZ, ForwardX, ForwardY, ForwardZ, LengthSquared);
+
+		// Keep lanes that beat their best and pass the distance gate
+		const VectorRegister Mask = VectorBitwiseAnd(VectorCompareGT(Dots, BestDots), VectorCompareGE(MaxDistanceSquaredV, LengthSquared));
+		BestDots = VectorSelect(Mask, Dots, BestDots);
+		BestIndices = VectorSelect(Mask, Indices, BestIndices);
+
+		Indices = VectorAdd(Indices, IndexStep);
+	}
+
+	// Reduce lanes, on ties keep the lowest index like the scalar loop
+	float LaneDots[4];
+	float LaneIndices[4];
+	VectorStore(BestDots, LaneDots);
+	VectorStore(BestIndices, LaneIndices);
+
+	int32 BestIndex = INDEX_NONE;
+	OutDot = MinDot;
+	for (int32 Lane = 0; Lane < 4; Lane++)
+	{
+		const int32 LaneIndex = (int32)LaneIndices[Lane];
+		if (LaneIndex < 0)
+			continue;
+
+		if (LaneDots[Lane] > OutDot || (LaneDots[Lane] == OutDot && LaneIndex < BestIndex))
+		{
+			BestIndex = LaneIndex;
+			OutDot = LaneDots[Lane];
+		}
+	}
+
+	// Remaining candidates that don't fill a vector, scored one lane at a time
+	for (int32 i = NumVectorized; i < Num; i++)
+	{
+		float LengthSquared;
+		const float DotProd = ScoreDirection(FVector(X[i] - Origin.X, Y[i] - Origin.Y, Z[i] - Origin.Z), Forward, LengthSquared);
+		if (LengthSquared <= MaxDistanceSquared && DotProd > OutDot)
+		{
+			BestIndex = i;
+			OutDot = DotProd;
+		}
+	}
+
+	return BestIndex;
+}
+
+int32 FTargetScoring::FindBestCandidate(const FTargetCandidates& Candidates,
+	const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot)
+{
+	return FindBestCandidate(Candidates.X.GetData(), Candidates.Y.GetData(), Candidates.Z.GetData(), Candidates.Num(),
+		Origin, Forward, MinDot, MaxDistance, OutDot);
+}
+
+#if !UE_BUILD_SHIPPING
+
+// Microbenchmark of the vectorized kernel against the scalar loop
+// Usage: Venari.BenchTargetScoring [NumCandidates] [Iterations]
+static FAutoConsoleCommand BenchTargetScoringCommand(
+	TEXT("Venari.BenchTargetScoring"),
+	TEXT("Times FTargetScoring against the scalar scoring loop. Args: [NumCandidates=256] [Iterations=10000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumCandidates = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 256;
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10000;
+
+		FRandomStream Random(1234);
+		FTargetCandidates Candidates;
+		for (int32 i = 0; i < NumCandidates; i++)
+			Candidates.Add(nullptr, Random.GetUnitVector() * Random.FRandRange(100.0f, 2000.0f));
+
+		const FVector Forward = FVector(1.0f, 0.2f, 0.1f).GetSafeNormal();
+
+		int32 ScalarIndex = INDEX_NONE;
+		float ScalarDot = 0.0f;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+			ScalarIndex = FTargetScoring::FindBestCandidateScalar(Candidates.X.GetData(), Candidates.Y.GetData(), Candidates.Z.GetData(),
+				NumCandidates, FVector::ZeroVector, Forward, 0.7f, 1500.0f, ScalarDot);
+		const double ScalarTime = FPlatformTime::Seconds() - StartTime;
+
+		int32 VectorIndex = INDEX_NONE;
+		float VectorDot = 0.0f;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+			VectorIndex = FTargetScoring::FindBestCandidate(Candidates, FVector::ZeroVector, Forward, 0.7f, 1500.0f, VectorDot);
+		const double VectorTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogTemp, Display, TEXT("Target scoring, %d candidates x %d iterations: scalar %.3f ms, vector %.3f ms (x%.2f). Best scalar %d (%.4f), vector %d (%.4f)."),
+			NumCandidates, Iterations, ScalarTime * 1000.0, VectorTime * 1000.0, VectorTime > 0.0 ? ScalarTime / VectorTime : 0.0,
+			ScalarIndex, ScalarDot, VectorIndex, VectorDot);
+	}));
+
+#endif
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Struct of arrays buffer of target candidates, fed to FTargetScoring
+ */
+struct PROJECTM_API FTargetCandidates
+{
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+	TArray<AActor*> Actors;
+
+	void Reset();
+	void Add(AActor* Actor, const FVector& Location);
+	int32 Num() const { return Actors.Num(); }
+};
+
+/**
+ * Scores target candidates by how close they are to the center of the screen,
+ * processing four candidates at a time with vector registers.
+ */
+class PROJECTM_API FTargetScoring
+{
+public:
+	// Returns the index of the candidate whose direction from origin has the highest dot product with forward
+	// Only candidates above MinDot and within MaxDistance of origin are considered (MaxDistance <= 0 doesn't gate distance)
+	// Returns INDEX_NONE if no candidate passes, OutDot is set to the best candidate's dot product
+	static int32 FindBestCandidate(const float* X, const float* Y, const float* Z, int32 Num,
+		const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot);
+	static int32 FindBestCandidate(const FTargetCandidates& Candidates,
+		const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot);
+
+	// Scalar version of FindBestCandidate, used as reference for the vectorized one, dot products may differ in the last bits
+	static int32 FindBestCandidateScalar(const float* X, const float* Y, const float* Z, int32 Num,
+		const FVector& Origin, const FVector& Forward, float MinDot, float MaxDistance, float& OutDot);
+
+	// Dot product between forward and the direction from origin to location, computed exactly like FindBestCandidate's
+	static float ScoreLocation(const FVector& Location, const FVector& Origin, const FVector& Forward);
+};
@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TraceSchedulerSubsystem.h"
+#include "ProjectM.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Trace scheduler flush"), STAT_VenariTraceSchedulerFlush, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled line traces"), STAT_VenariScheduledLineTraces, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled overlaps"), STAT_VenariScheduledOverlaps, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Completed queries"), STAT_VenariCompletedQueries, STATGROUP_Venari);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Query latency avg (ms)"), STAT_VenariQueryLatencyAvg, STATGROUP_Venari);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Query latency max (ms)"), STAT_VenariQueryLatencyMax, STATGROUP_Venari);
+
+void UTraceSchedulerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LineTraceDelegate.BindUObject(this, &UTraceSchedulerSubsystem::OnLineTraceComplete);
+	OverlapDelegate.BindUObject(this, &UTraceSchedulerSubsystem::OnOverlapComplete);
+}
+
+void UTraceSchedulerSubsystem::Deinitialize()
+{
+	QueuedLineTraces.Reset();
+	QueuedOverlaps.Reset();
+	RunningQueries.Reset();
+
+	LineTraceDelegate.Unbind();
+	OverlapDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+ETickableTickType UTraceSchedulerSubsystem::GetTickableTickType() const
+{
+	// Never tick the class default object
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UTraceSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTraceSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+uint64 UTraceSchedulerSubsystem::RequestLineTrace(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params, FScheduledTraceDelegate Callback)
+{
+	FScheduledLineTrace& Request = QueuedLineTraces.AddDefaulted_GetRef();
+	Request.RequestId = NextRequestId++;
+	Request.Start = Start;
+	Request.End = End;
+	Request.TraceChannel = TraceChannel;
+	Request.Params = Params;
+	Request.Callback = MoveTemp(Callback);
+	Request.RequestTime = FPlatformTime::Seconds();
+
+	return Request.RequestId;
+}
+
+uint64 UTraceSchedulerSubsystem::RequestOverlap(const FVector& Location, const FCollisionShape& Shape, const FCollisionObjectQueryParams& ObjectParams,
+	const FCollisionQueryParams& Params, FScheduledOverlapDelegate Callback)
+{
+	FScheduledOverlap& Request = QueuedOverlaps.AddDefaulted_GetRef();
+	Request.RequestId = NextRequestId++;
+	Request.Location = Location;
+	Request.Shape = Shape;
+	Request.ObjectParams = ObjectParams;
+	Request.Params = Params;
+	Request.Callback = MoveTemp(Callback);
+	Request.RequestTime = FPlatformTime::Seconds();
+
+	return Request.RequestId;
+}
+
+void UTraceSchedulerSubsystem::CancelRequest(uint64 RequestId)
+{
+	if (RequestId == 0)
+		return;
+
+	QueuedLineTraces.RemoveAll([RequestId](const FScheduledLineTrace& Request) { return Request.RequestId == RequestId; });
+	QueuedOverlaps.RemoveAll([RequestId](const FScheduledOverlap& Request) { return Request.RequestId == RequestId; });
+
+	// Only a few queries run at once, a linear search is enough
+	for (auto It = RunningQueries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().RequestId == RequestId)
+		{
+			It.RemoveCurrent();
+			return;
+		}
+	}
+}
+
+// Submit every query requested this frame in one pass, results come back at the start of next frame
+void UTraceSchedulerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VenariTraceSchedulerFlush);
+
+	UWorld* World = GetWorld();
+	if (!World)
+		return;
+
+	for (FScheduledLineTrace& Request : QueuedLineTraces)
+	{
+		const FTraceHandle TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Request.Start, Request.End, Request.TraceChannel,
+			Request.Params, FCollisionResponseParams::DefaultResponseParam, &LineTraceDelegate);
+
+		FRunningQuery& Query = RunningQueries.Add(TraceHandle._Handle);
+		Query.RequestId = Request.RequestId;
+		Query.TraceCallback = MoveTemp(Request.Callback);
+		Query.RequestTime = Request.RequestTime;
+	}
+
+	for (FScheduledOverlap& Request : QueuedOverlaps)
+	{
+		const FTraceHandle TraceHandle = World->AsyncOverlapByObjectType(Request.Location, FQuat::Identity, Request.ObjectParams, Request.Shape,
+			Request.Params, &OverlapDelegate);
+
+		FRunningQuery& Query = RunningQueries.Add(TraceHandle._Handle);
+		Query.RequestId = Request.RequestId;
+		Query.OverlapCallback = MoveTemp(Request.Callback);
+		Query.RequestTime = Request.RequestTime;
+	}
+
+	CurrentFrameStats.NumLineTraces = QueuedLineTraces.Num();
+	CurrentFrameStats.NumOverlaps = QueuedOverlaps.Num();
+	if (CurrentFrameStats.NumCompleted > 0)
+		CurrentFrameStats.AverageLatencyMs = (float)(CurrentFrameLatencySum / CurrentFrameStats.NumCompleted);
+
+	INC_DWORD_STAT_BY(STAT_VenariScheduledLineTraces, CurrentFrameStats.NumLineTraces);
+	INC_DWORD_STAT_BY(STAT_VenariScheduledOverlaps, CurrentFrameStats.NumOverlaps);
+	INC_DWORD_STAT_BY(STAT_VenariCompletedQueries, CurrentFrameStats.NumCompleted);
+	SET_FLOAT_STAT(STAT_VenariQueryLatencyAvg, CurrentFrameStats.AverageLatencyMs);
+	SET_FLOAT_STAT(STAT_VenariQueryLatencyMax, CurrentFrameStats.MaxLatencyMs);
+
+	LastFrameStats = CurrentFrameStats;
+	CurrentFrameStats = FTraceSchedulerFrameStats();
+	CurrentFrameLatencySum = 0.0;
+
+	QueuedLineTraces.Reset();
+	QueuedOverlaps.Reset();
+}
+
+void UTraceSchedulerSubsystem::OnLineTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FRunningQuery Query;
+	if (!RunningQueries.RemoveAndCopyValue(TraceHandle._Handle, Query))
+		return;
+
+	RecordLatency(Query.RequestTime);
+	Query.TraceCallback.ExecuteIfBound(Query.RequestId, TraceDatum);
+}
+
+void UTraceSchedulerSubsystem::OnOverlapComplete(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum)
+{
+	FRunningQuery Query;
+	if (!RunningQueries.RemoveAndCopyValue(TraceHandle._Handle, Query))
+		return;
+
+	RecordLatency(Query.RequestTime);
+	Query.OverlapCallback.ExecuteIfBound(Query.RequestId, OverlapDatum);
+}
+
+void UTraceSchedulerSubsystem::RecordLatency(double RequestTime)
+{
+	const float LatencyMs = (float)((FPlatformTime::Seconds() - RequestTime) * 1000.0);
+
+	CurrentFrameStats.NumCompleted++;
+	CurrentFrameStats.MaxLatencyMs = FMath::Max(CurrentFrameStats.MaxLatencyMs, LatencyMs);
+	CurrentFrameLatencySum += LatencyMs;
+}
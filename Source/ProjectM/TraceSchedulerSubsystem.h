@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "TraceSchedulerSubsystem.generated.h"
+
+DECLARE_DELEGATE_TwoParams(FScheduledTraceDelegate, uint64 /*RequestId*/, const FTraceDatum& /*TraceDatum*/);
+DECLARE_DELEGATE_TwoParams(FScheduledOverlapDelegate, uint64 /*RequestId*/, const FOverlapDatum& /*OverlapDatum*/);
+
+/**
+ * Query counts and latencies of the last frame, also available through "stat Venari"
+ */
+struct FTraceSchedulerFrameStats
+{
+	int32 NumLineTraces = 0; // Line traces submitted
+	int32 NumOverlaps = 0; // Overlaps submitted
+	int32 NumCompleted = 0; // Results delivered to their callbacks
+	float AverageLatencyMs = 0.0f; // Average time between request and result
+	float MaxLatencyMs = 0.0f; // Longest time between request and result
+};
+
+/**
+ * Collects gameplay scene queries during the frame and submits them all at once as async traces.
+ * Results are delivered to the request callbacks on the next frame, so trace cost stays off the game thread.
+ */
+UCLASS()
+class PROJECTM_API UTraceSchedulerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	// Queue a single line trace by channel, returns the request id passed to the callback
+	uint64 RequestLineTrace(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params, FScheduledTraceDelegate Callback);
+	// Queue a multi overlap by object type, returns the request id passed to the callback
+	uint64 RequestOverlap(const FVector& Location, const FCollisionShape& Shape, const FCollisionObjectQueryParams& ObjectParams,
+		const FCollisionQueryParams& Params, FScheduledOverlapDelegate Callback);
+
+	// Drop a queued or running request, its callback won't be called
+	void CancelRequest(uint64 RequestId);
+
+	const FTraceSchedulerFrameStats& GetLastFrameStats() const { return LastFrameStats; }
+
+private:
+	struct FScheduledLineTrace
+	{
+		uint64 RequestId;
+		FVector Start;
+		FVector End;
+		ECollisionChannel TraceChannel;
+		FCollisionQueryParams Params;
+		FScheduledTraceDelegate Callback;
+		double RequestTime;
+	};
+
+	struct FScheduledOverlap
+	{
+		uint64 RequestId;
+		FVector Location;
+		FCollisionShape Shape;
+		FCollisionObjectQueryParams ObjectParams;
+		FCollisionQueryParams Params;
+		FScheduledOverlapDelegate Callback;
+		double RequestTime;
+	};
+
+	struct FRunningQuery
+	{
+		uint64 RequestId;
+		FScheduledTraceDelegate TraceCallback;
+		FScheduledOverlapDelegate OverlapCallback;
+		double RequestTime;
+	};
+
+	void OnLineTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void OnOverlapComplete(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum);
+	void RecordLatency(double RequestTime);
+
+	TArray<FScheduledLineTrace> QueuedLineTraces; // Line traces requested this frame
+	TArray<FScheduledOverlap> QueuedOverlaps; // Overlaps requested this frame
+	TMap<uint64, FRunningQuery> RunningQueries; // Submitted queries, keyed by the full value of their async trace handle
+
+	FTraceDelegate LineTraceDelegate;
+	FOverlapDelegate OverlapDelegate;
+
+	uint64 NextRequestId = 1;
+
+	FTraceSchedulerFrameStats CurrentFrameStats; // Stats being gathered this frame
+	FTraceSchedulerFrameStats LastFrameStats;
+	double CurrentFrameLatencySum = 0.0;
+};
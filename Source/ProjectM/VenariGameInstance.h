@@ -18,7 +18,19 @@ class PROJECTM_API UVenariGameInstance : public UGameInstance
 
 public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-		TArray<FItemStruct> InventoryData;
+		TArray<FItemStruct> InventoryData; // Starting inventory, then a copy of the inventory subsystem's slots for the widgets, change it through the subsystem
+
+	UPROPERTY(EditAnywhere)
+		class UDataTable* ItemsDataTable; // Static item data, DT_ItemsData is loaded if not set
+
+	UPROPERTY(EditAnywhere)
+		class UDataTable* LevelsDataTable; // Levels and their unlocks, DT_LevelsData is loaded if not set
+
+	UPROPERTY(EditAnywhere)
+		class UDataTable* QuestsDataTable; // Quests and their objectives, BT_QuestInfo is loaded if not set
+
+	UPROPERTY(EditAnywhere)
+		class UDataTable* MonsterHintsDataTable; // Notebook hints of every monster, DT_MonsterHints is loaded if not set
 
 	UPROPERTY(BlueprintReadWrite)
 		int EquippedItemIndex = 0;
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VfxSubsystem.h"
+#include "ProjectM.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("VFX spawned"), STAT_VenariVfxSpawned, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VFX culled by distance"), STAT_VenariVfxCulledDistance, STATGROUP_Venari);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VFX culled by budget"), STAT_VenariVfxCulledBudget, STATGROUP_Venari);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFX prewarmed"), STAT_VenariVfxPrewarmed, STATGROUP_Venari);
+
+void UVfxSubsystem::Deinitialize()
+{
+	int32 NumPrewarmed = 0;
+	for (const TPair<const UNiagaraSystem*, FPrewarmedPool>& Prewarmed : PrewarmedPools)
+		NumPrewarmed += Prewarmed.Value.Count;
+	DEC_DWORD_STAT_BY(STAT_VenariVfxPrewarmed, NumPrewarmed);
+
+	SystemSpawnsThisFrame.Reset();
+	PrewarmedPools.Reset();
+
+	Super::Deinitialize();
+}
+
+// Spawn inactive components and hand them straight back to the pool
+// The pool doesn't expose its size, components left unused longer than its kill time may have been freed, so they're counted again
+void UVfxSubsystem::Prewarm(UNiagaraSystem* System, int32 Count)
+{
+	if (System == nullptr)
+		return;
+
+	static const IConsoleVariable* CVarKillUnusedTime = IConsoleManager::Get().FindConsoleVariable(TEXT("FX.NiagaraComponentPool.KillUnusedTime"));
+	const double KillUnusedTime = CVarKillUnusedTime ? CVarKillUnusedTime->GetFloat() : 180.0;
+
+	FPrewarmedPool& Prewarmed = PrewarmedPools.FindOrAdd(System);
+	const double Now = GetWorld()->GetTimeSeconds(); // Same clock the pool uses for unused times
+	if (Prewarmed.Count > 0 && Now - Prewarmed.Time > KillUnusedTime)
+	{
+		DEC_DWORD_STAT_BY(STAT_VenariVfxPrewarmed, Prewarmed.Count);
+		Prewarmed.Count = 0;
+	}
+
+	const int32 NumToSpawn = Count - Prewarmed.Count;
+	if (NumToSpawn <= 0)
+		return;
+
+	// Components have to be alive at the same time, or the pool would hand back the same one
+	TArray<UNiagaraComponent*> Components;
+	for (int32 i = 0; i < NumToSpawn; i++)
+	{
+		UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, FVector::ZeroVector,
+			FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::ManualRelease, false);
+		if (Component)
+			Components.Add(Component);
+	}
+
+	for (UNiagaraComponent* Component : Components)
+		Component->ReleaseToPool();
+
+	Prewarmed.Count += Components.Num();
+	Prewarmed.Time = Now;
+	INC_DWORD_STAT_BY(STAT_VenariVfxPrewarmed, Components.Num());
+}
+
+bool UVfxSubsystem::ConsumeSpawnBudget(const UNiagaraSystem* System)
+{
+	// Budgets are per frame, reset them on the first spawn of a new frame
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SpawnsThisFrame = 0;
+		SystemSpawnsThisFrame.Reset();
+	}
+
+	int32& SystemSpawns = SystemSpawnsThisFrame.FindOrAdd(System);
+	if (SpawnsThisFrame >= MaxSpawnsPerFrame || SystemSpawns >= MaxSpawnsPerSystemPerFrame)
+		return false;
+
+	SpawnsThisFrame++;
+	SystemSpawns++;
+	return true;
+}
+
+bool UVfxSubsystem::IsInSignificanceRange(const FVector& Location) const
+{
+	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+	if (PlayerController == nullptr)
+		return true;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	return FVector::DistSquared(ViewLocation, Location) <= FMath::Square(SignificanceRadius);
+}
+
+UNiagaraComponent* UVfxSubsystem::SpawnSystemAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	if (System == nullptr)
+		return nullptr;
+
+	if (!IsInSignificanceRange(Location))
+	{
+		INC_DWORD_STAT(STAT_VenariVfxCulledDistance);
+		return nullptr;
+	}
+
+	if (!ConsumeSpawnBudget(System))
+	{
+		INC_DWORD_STAT(STAT_VenariVfxCulledBudget);
+		return nullptr;
+	}
+
+	INC_DWORD_STAT(STAT_VenariVfxSpawned);
+	return UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, Location, Rotation, FVector(1.0f),
+		true, true, ENCPoolMethod::AutoRelease, true);
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VfxSubsystem.generated.h"
+
+class UNiagaraSystem;
+class UNiagaraComponent;
+
+/**
+ * Spawns gameplay effects from the world's Niagara component pool.
+ * Effects are prewarmed at level load, spawns are capped per frame and per system,
+ * and effects too far from the player's view are culled instead of spawned.
+ * Budgets are read from the game config, under [/Script/ProjectM.VfxSubsystem].
+ */
+UCLASS(config = Game)
+class PROJECTM_API UVfxSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Spawn a pooled effect that returns to the pool once complete, returns null if it was culled
+	UNiagaraComponent* SpawnSystemAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation);
+
+	// Fill the pool of the system with at least Count components, again once the pool may have freed them
+	void Prewarm(UNiagaraSystem* System, int32 Count);
+
+private:
+	bool ConsumeSpawnBudget(const UNiagaraSystem* System); // False if the frame or system spawn budget is spent
+	bool IsInSignificanceRange(const FVector& Location) const;
+
+	UPROPERTY(Config)
+		int32 MaxSpawnsPerFrame = 16;
+	UPROPERTY(Config)
+		int32 MaxSpawnsPerSystemPerFrame = 4;
+	UPROPERTY(Config)
+		float SignificanceRadius = 8000.0f; // Effects further than this from the player's view are culled
+
+	uint64 BudgetFrame = 0; // Frame the spawn counts below belong to
+	int32 SpawnsThisFrame = 0;
+	TMap<const UNiagaraSystem*, int32> SystemSpawnsThisFrame;
+
+	struct FPrewarmedPool
+	{
+		int32 Count = 0; // Components added to the system's pool
+		double Time = 0.0; // World time of the last prewarm
+	};
+	TMap<const UNiagaraSystem*, FPrewarmedPool> PrewarmedPools;
+};